@@ -0,0 +1,74 @@
+#ifndef APPROX_H
+#define APPROX_H
+
+#include "graph.h"
+
+struct ApproxBucket;
+
+/*
+ * Approximate (1+eps) shortest paths with a bucket queue.
+ *
+ * Tentative distances are rounded down into buckets of width
+ * (1 + eps) * w_min, where w_min is the smallest arc weight of the
+ * graph, kept in a ring of (w_max / width + 2) buckets (Dial's queue).
+ * The nodes of the current bucket are settled in any order (LIFO), each
+ * exactly once, and never reopened. Settling a node out of order within
+ * a bucket costs at most width - w_min = eps * w_min per arc, and a path
+ * with k arcs is at least k * w_min long, so every label satisfies
+ *     d*(v) <= dist[v] <= (1 + eps) * d*(v).
+ * eps = 0 gives exact distances (plain Dial). Arcs of weight 0 are
+ * ignored when computing w_min and void the bound.
+ *
+ * APPROX_WIDTH_MEAN is a heuristic without that guarantee: the width is
+ * w_min + eps * w_mean, so on integer weights (w_min = 1) eps actually
+ * widens the buckets. The error is about eps on paths of mean-weight
+ * arcs, but only eps * w_mean / w_min is guaranteed.
+ *
+ * The workspace is reused between searches and reset through touched
+ * lists, so a search costs time proportional to its search space.
+ */
+
+// How approx_create derives the bucket width from eps.
+typedef enum {
+    APPROX_WIDTH_MIN,         // (1 + eps) * w_min, error at most eps
+    APPROX_WIDTH_MEAN         // w_min + eps * w_mean, heuristic, no (1+eps) bound
+} ApproxWidth;
+
+typedef struct {
+    const Graph *g;
+    double eps;
+    ApproxWidth rule;
+    double width;             // Bucket width
+    double bound;             // Guaranteed relative error (eps for APPROX_WIDTH_MIN)
+    int num_buckets;          // Ring size
+    struct ApproxBucket *ring;
+
+    double *dist;             // Labels of the last search (DBL_MAX = not reached)
+    unsigned char *settled;
+    int *touched;             // Nodes whose label must be reset
+    int num_touched;
+    int *used;                // Ring slots that may still hold entries
+    int num_used;
+    int used_cap;
+} ApproxSearch;
+
+/**
+ * Creates a workspace for approximate searches on 'g' with the bucket
+ * width given by 'rule' (APPROX_WIDTH_MIN for the (1+eps) guarantee).
+ * Negative 'eps' is treated as 0. Exits on allocation failure.
+ */
+ApproxSearch* approx_create(const Graph *g, double eps, ApproxWidth rule);
+
+/**
+ * Runs a search from 's'. With 0 <= t < num_nodes the search stops once
+ * 't' is settled and its approximate distance is returned
+ * (DBL_MAX if unreachable). With t = -1 it runs a full SSSP and returns
+ * DBL_MAX. a->dist holds the labels until the next call.
+ * If 'settled' is not NULL it receives the number of settled nodes.
+ */
+double approx_query(ApproxSearch *a, int s, int t, int *settled);
+
+// Frees the workspace (the graph is not owned).
+void approx_free(ApproxSearch *a);
+
+#endif // APPROX_H
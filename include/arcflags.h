@@ -0,0 +1,46 @@
+#ifndef ARCFLAGS_H
+#define ARCFLAGS_H
+
+#include "graph.h"
+
+/*
+ * Arc flags for goal-directed pruning.
+ *
+ * The graph is split into k regions. Every arc stores one bit per
+ * region that is set if the arc lies on some shortest path into that
+ * region. A point-to-point search towards t may then skip every arc
+ * whose bit for region(t) is clear.
+ *
+ * Arcs are numbered in adjacency-list order: the i-th arc of g->adj[u]
+ * has id offset[u] + i, so the flags sit alongside the adjacency lists
+ * in one contiguous bit array without touching the Edge struct.
+ */
+typedef struct {
+    int num_regions;              // k (actual number of regions produced)
+    int words;                    // 64-bit words per arc = ceil(k / 64)
+    int *region;                  // region[v] = region of node v
+    long *offset;                 // offset[u] = id of u's first arc (size n + 1)
+    long num_arcs;                // Total number of arcs (offset[n])
+    unsigned long long *flags;    // flags[arc * words + r / 64], bit r % 64
+} ArcFlags;
+
+/**
+ * Partitions 'g' into about 'num_regions' regions and computes the
+ * flags with one backward Dijkstra per region boundary node.
+ * Boundary searches run in parallel when compiled with -fopenmp.
+ * Exits on allocation failure.
+ */
+ArcFlags* arcflags_build(const Graph *g, int num_regions);
+
+// Returns non-zero if arc 'arc' carries the flag of 'region'.
+static inline int arcflags_test(const ArcFlags *af, long arc, int region) {
+    return (int)((af->flags[arc * af->words + (region >> 6)] >> (region & 63)) & 1ULL);
+}
+
+// Bytes used by the flag bit array.
+long arcflags_bytes(const ArcFlags *af);
+
+// Frees all memory associated with the arc flags.
+void free_arcflags(ArcFlags *af);
+
+#endif // ARCFLAGS_H
@@ -0,0 +1,42 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "graph.h"
+
+// Outcome of one query in a batch, stored at the query's input position.
+typedef struct {
+    double dist;          // Shortest distance (DBL_MAX if unreachable)
+    double latency;       // Wall time of the search itself on its worker
+    double cpu_time;      // CPU time of the worker thread during the search
+    int worker;           // Worker thread that answered the query
+} BatchResult;
+
+// Aggregate statistics of one batch run.
+typedef struct {
+    double wall_time;     // Wall time of the whole batch (seconds)
+    int num_workers;      // Worker threads actually used
+    long steals;          // Successful steal operations
+    long stolen;          // Queries moved by stealing
+} BatchStats;
+
+/**
+ * Answers 'n' (s, t) queries (0-based pairs in 'queries') on a pool
+ * of worker threads.
+ *
+ * Each worker owns one dist array and one heap ('heap_type' = fib | pair)
+ * for the whole batch. Queries are split into one contiguous deque per
+ * worker; a worker that runs dry steals half of another worker's
+ * remaining queries, so a few long queries cannot stall the batch.
+ * Latency is measured around the search only, on the worker that runs
+ * it, so queueing and steal traffic do not leak into per-query numbers;
+ * the thread CPU time is recorded as well, which also excludes time the
+ * worker spent descheduled when threads outnumber cores.
+ *
+ * 'results[i]' receives query i's answer (input order is preserved).
+ * 'num_threads' <= 0 uses the OpenMP default.
+ * Returns 0 on success, -1 for an unknown heap type.
+ */
+int run_query_batch(const Graph *g, const int *queries, int n, const char *heap_type,
+                    int num_threads, BatchResult *results, BatchStats *stats);
+
+#endif // BATCH_H
@@ -0,0 +1,81 @@
+#ifndef CONTRACT_H
+#define CONTRACT_H
+
+#include "graph.h"
+
+/*
+ * Degree-2 chain contraction.
+ *
+ * A node is a chain node if it has exactly two distinct neighbours a
+ * and b, and traffic can only pass through it: a -> v exists iff
+ * v -> b exists, and b -> v exists iff v -> a exists. Maximal runs of
+ * chain nodes between two kept nodes x and y are replaced by at most
+ * two shortcut arcs (x -> y and y -> x, weighted with the chain length
+ * in that direction). A ring made only of chain nodes keeps one node.
+ *
+ * Every chain node keeps its chain slot with its distances to and from
+ * both chain ends, so queries that start or end inside a chain are
+ * answered exactly, and shortcut arcs can be expanded back into the
+ * original nodes.
+ */
+typedef struct {
+    Graph *g;             // Contracted graph (owned)
+    int orig_nodes;       // Node count of the original graph
+    long orig_edges;      // Arc count of the original graph
+
+    int *new_id;          // new_id[v] = node in g, or -1 for chain nodes
+    int *old_id;          // old_id[k] = original id of node k of g
+
+    // Chains, chain nodes stored in order from end x to end y
+    int num_chains;
+    int *chain_start;     // CSR offsets into the slot arrays per chain
+    int *chain_x;         // Original id of the x end
+    int *chain_y;         // Original id of the y end
+    double *chain_fw;     // Length x -> y (DBL_MAX if the chain is one-way y -> x)
+    double *chain_bw;     // Length y -> x
+    int *end_start;       // CSR offsets per node of g: chains ending there
+    int *end_chain;
+
+    // Per chain node ("slot"), indexed through slot[v]
+    int *slot;            // slot[v] = slot of chain node v, or -1
+    int *slot_node;       // Original id of the node in each slot
+    int *slot_chain;      // Chain of each slot
+    double *fw_in;        // x -> v along the chain (DBL_MAX if one-way the other way)
+    double *fw_out;       // v -> y
+    double *bw_in;        // y -> v
+    double *bw_out;       // v -> x
+} Contraction;
+
+/**
+ * Builds the contracted graph of 'g'. The original graph is not
+ * modified and is not referenced after this call returns.
+ */
+Contraction* contract_graph(const Graph *g);
+
+/**
+ * Exact SSSP from original node 's' computed on the contracted graph.
+ * 'out' (orig_nodes entries) receives the distances to all original
+ * nodes. 'heap_type' is "fib" or "pair". Returns 0, or -1 for an
+ * unknown heap type.
+ */
+int contract_sssp(const Contraction *c, int s, const char *heap_type, double *out);
+
+/**
+ * Exact s-t distance between original nodes, searching the contracted
+ * graph until the kept nodes next to 't' are settled.
+ * Returns DBL_MAX if unreachable (or for an unknown heap type).
+ */
+double contract_query(const Contraction *c, int s, int t, const char *heap_type);
+
+/**
+ * Expands the arc (u -> v) of the contracted graph with weight 'weight'.
+ * Writes the original ids of the chain nodes it replaces, in path
+ * order, to 'out' (at most 'max' entries) and returns their number:
+ * 0 for an original arc, -1 if no such arc exists.
+ */
+int contract_expand_arc(const Contraction *c, int u, int v, double weight, int *out, int max);
+
+// Frees the contraction and its contracted graph.
+void free_contraction(Contraction *c);
+
+#endif // CONTRACT_H
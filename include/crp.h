@@ -0,0 +1,83 @@
+#ifndef CRP_H
+#define CRP_H
+
+#include "graph.h"
+#include "partition.h"
+
+/*
+ * Customizable Route Planning (CRP / multi-level Dijkstra).
+ *
+ * Work is split into three stages:
+ *  1. crp_build:     metric-independent. Partitions the graph and
+ *                    derives the overlay topology (boundary nodes of
+ *                    every cell on every level). Never reads weights.
+ *  2. crp_customize: metric-dependent. Recomputes the clique distances
+ *                    between boundary nodes of every cell from the
+ *                    current Edge.weight values, bottom-up, with the
+ *                    cells of one level processed in parallel.
+ *  3. crp_query:     point-to-point search that only scans original
+ *                    arcs inside the lowest cells of s and t and uses
+ *                    cell cliques everywhere else.
+ */
+
+// Opaque overlay type. The implementation is hidden in the .c file.
+typedef struct CrpOverlay CrpOverlay;
+
+// Opaque per-thread query workspace.
+typedef struct CrpQuery CrpQuery;
+
+/**
+ * Builds the partition and overlay topology for 'g'.
+ * 'cell_sizes[l]' is the maximum cell size on level l (increasing).
+ * The overlay keeps a pointer to 'g'; the graph must outlive it.
+ * Cliques are not valid until crp_customize has been called.
+ */
+CrpOverlay* crp_build(const Graph *g, int num_levels, const int *cell_sizes);
+
+/**
+ * Recomputes all cell cliques from the current arc weights.
+ * Call again after any update_edge_weight() on the graph.
+ * Uses OpenMP threads when compiled with -fopenmp.
+ */
+void crp_customize(CrpOverlay *o);
+
+// Returns the underlying partition (owned by the overlay).
+const Partition* crp_partition(const CrpOverlay *o);
+
+// Number of nodes that are boundary nodes on level 0 (the overlay vertices).
+int crp_num_overlay_nodes(const CrpOverlay *o);
+
+// Number of clique entries stored on level 'level'.
+long crp_num_clique_entries(const CrpOverlay *o, int level);
+
+/**
+ * Creates a reusable query workspace. Distances are reset only for the
+ * nodes touched by the previous query, so a query costs time proportional
+ * to its search space rather than to the graph size.
+ */
+CrpQuery* crp_query_create(const CrpOverlay *o);
+
+/**
+ * Returns the shortest s-t distance (DBL_MAX if unreachable).
+ * If 'out_settled' is non-NULL, stores the number of scanned nodes.
+ */
+double crp_query(CrpQuery *q, int s, int t, int *out_settled);
+
+/**
+ * Computes the num_sources x num_targets distance table (row-major,
+ * row = source) with one backward search per target and one forward
+ * search per source on the overlay, joined through per-node buckets.
+ * Invalid or unreachable entries are DBL_MAX.
+ * Uses OpenMP threads when compiled with -fopenmp.
+ * Returns the total number of nodes settled by all searches.
+ */
+long crp_distance_table(const CrpOverlay *o, const int *sources, int num_sources,
+                        const int *targets, int num_targets, double *table);
+
+// Frees a query workspace.
+void crp_query_free(CrpQuery *q);
+
+// Frees the overlay and its partition (not the graph).
+void crp_free(CrpOverlay *o);
+
+#endif // CRP_H
@@ -0,0 +1,22 @@
+#ifndef DELTASTEP_H
+#define DELTASTEP_H
+
+#include "graph.h"
+
+/**
+ * Parallel delta-stepping SSSP (Meyer & Sanders).
+ *
+ * Nodes are kept in buckets of width 'delta'. The lowest non-empty
+ * bucket is emptied in rounds that relax only light arcs
+ * (weight <= delta); heavy arcs of every node settled in the bucket
+ * are relaxed once afterwards. Each thread owns its own bucket
+ * buffers, and tentative distances are lowered with an atomic
+ * compare-and-swap min.
+ *
+ * 'delta' <= 0 selects the average arc weight.
+ * 'num_threads' <= 0 uses the OpenMP default (OMP_NUM_THREADS).
+ * Returns a new distance array like dijkstra_fibheap; caller frees it.
+ */
+double* dijkstra_delta(const Graph *g, int s, double delta, int num_threads);
+
+#endif // DELTASTEP_H
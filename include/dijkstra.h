@@ -4,6 +4,16 @@
 #include "graph.h"
 #include "fibheap.h"
 #include "pairingheap.h"
+#include "arcflags.h"
+
+// Limits for one search. A zero field means "no limit".
+typedef struct {
+    double deadline;      // Absolute timer_now() time after which the search stops
+    long max_settled;     // Maximum number of nodes to settle
+} SearchBudget;
+
+// Extractions between two clock reads in the budgeted kernels.
+#define BUDGET_CHECK_INTERVAL 1024
 
 /**
  * Runs Dijkstra's algorithm using a Fibonacci heap.
@@ -19,4 +29,85 @@ double* dijkstra_fibheap(const Graph *g, int s);
  */
 double* dijkstra_pairingheap(const Graph *g, int s);
 
+/**
+ * Bidirectional Dijkstra on one thread: forward and backward steps
+ * alternate, each with its own binary heap. Returns the s-t distance
+ * (DBL_MAX if unreachable); optional outputs are the nodes expanded
+ * by each side.
+ */
+double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visited, int *out_backward_visited);
+
+/**
+ * Bidirectional Dijkstra with the forward and backward searches on two
+ * concurrent threads (OpenMP sections). The sides share a lock-free best
+ * distance and stop through an atomic flag once the sum of their current
+ * keys reaches it. Same contract as dijkstra_bi_one_query.
+ */
+double dijkstra_bi_concurrent(const Graph *g, int s, int t, int *out_forward_visited, int *out_backward_visited);
+
+/**
+ * Runs Dijkstra's algorithm using a caller-owned Fibonacci heap.
+ * 'dist' (n entries) is (re)initialized here. 'H' must be empty and
+ * created for at least g->num_nodes nodes; it is empty again on return,
+ * so one heap and one dist array can serve many queries.
+ */
+void dijkstra_fib_ws(const Graph *g, int s, double *dist, FibHeap *H);
+
+/**
+ * Runs Dijkstra's algorithm using a caller-owned Pairing heap.
+ * Same contract as dijkstra_fib_ws.
+ */
+void dijkstra_pair_ws(const Graph *g, int s, double *dist, PairingHeap *H);
+
+/**
+ * Dijkstra with a caller-owned Fibonacci heap that gives up once
+ * 'budget' (may be NULL) is exhausted. 'dist' must already be all
+ * DBL_MAX and 'H' empty, so callers can time setup and search apart.
+ * If 't' is a node the search stops once it is settled (dist[t] is then
+ * final); t = -1 runs a full SSSP.
+ * The settled-node limit is checked on every extraction, the deadline
+ * every BUDGET_CHECK_INTERVAL extractions. Returns 1 if the search
+ * completed, 0 if it was aborted ('dist' then holds tentative values).
+ * The heap is left empty either way.
+ */
+int dijkstra_fib_budget(const Graph *g, int s, int t, double *dist, FibHeap *H,
+                        const SearchBudget *budget);
+
+/**
+ * Budgeted Dijkstra with a Pairing heap; same contract as
+ * dijkstra_fib_budget.
+ */
+int dijkstra_pair_budget(const Graph *g, int s, int t, double *dist, PairingHeap *H,
+                         const SearchBudget *budget);
+
+/**
+ * Point-to-point Dijkstra with a Fibonacci heap that stops as soon as
+ * 't' is settled. If 'af' is non-NULL, arcs whose flag for region(t)
+ * is clear are skipped. Returns the s-t distance (DBL_MAX if unreachable).
+ * Optional outputs: nodes settled, arcs scanned and arcs pruned.
+ */
+double dijkstra_fib_p2p(const Graph *g, int s, int t, const ArcFlags *af,
+                        int *out_settled, long *out_scanned, long *out_pruned);
+
+/**
+ * Point-to-point Dijkstra with a Pairing heap; same contract as
+ * dijkstra_fib_p2p.
+ */
+double dijkstra_pair_p2p(const Graph *g, int s, int t, const ArcFlags *af,
+                         int *out_settled, long *out_scanned, long *out_pruned);
+
+/**
+ * Dijkstra with a Fibonacci heap from 's' that stops as soon as every
+ * node in 'targets' is settled (or the heap runs empty).
+ * out[i] receives the distance to targets[i] (DBL_MAX if unreachable);
+ * duplicate targets are allowed. Returns the number of settled nodes.
+ */
+int dijkstra_fib_targets(const Graph *g, int s, const int *targets, int num_targets, double *out);
+
+/**
+ * Multi-target Dijkstra with a Pairing heap; same contract as
+ * dijkstra_fib_targets.
+ */
+int dijkstra_pair_targets(const Graph *g, int s, const int *targets, int num_targets, double *out);
+
 #endif // DIJKSTRA_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef DYNSSSP_H
+#define DYNSSSP_H
+
+#include "graph.h"
+#include "pairingheap.h"
+
+// New weight for the arc (u -> v) (the first such arc if there are parallel arcs).
+typedef struct {
+    int u;
+    int v;
+    double weight;
+} WeightChange;
+
+/*
+ * Dynamic single-source shortest paths.
+ *
+ * Keeps the distances and the shortest-path tree of one source up to
+ * date while arc weights change, in the style of Ramalingam-Reps: after
+ * a batch of changes only the nodes whose distance or tree parent may
+ * change are searched again, instead of running a full SSSP.
+ *
+ * A batch is repaired in one pass with a Pairing heap:
+ *   1. Every tree arc whose weight increased cuts off the subtree below
+ *      it. The nodes of these subtrees ("affected") lose their labels
+ *      and are re-seeded from their unaffected in-neighbours.
+ *   2. Every arc whose weight decreased is relaxed once.
+ *   3. A Dijkstra over the seeded nodes propagates the new labels.
+ * Labels of unaffected nodes stay valid upper bounds throughout, so the
+ * result equals a full recomputation on the updated graph.
+ */
+typedef struct {
+    Graph *g;                 // Graph whose weights are changed (not owned)
+    int source;
+    double *dist;             // Current distances (DBL_MAX = unreachable)
+    int *parent;              // Tree parent, -1 for the source and unreachable nodes
+
+    // Workspace reused by every update
+    PairingHeap *heap;
+    unsigned char *affected;
+    int *stack;               // Affected nodes, also the DFS stack
+} DynamicSSSP;
+
+/**
+ * Computes the shortest-path tree of 's' on 'g' and returns the state
+ * for later updates. Exits on allocation failure.
+ */
+DynamicSSSP* dyn_create(Graph *g, int s);
+
+/**
+ * Applies 'k' weight changes to the graph (via update_edge_weight) and
+ * repairs the distances and the tree. Changes to missing arcs are
+ * ignored. Returns the number of nodes settled by the repair.
+ */
+long dyn_update(DynamicSSSP *d, const WeightChange *changes, int k);
+
+// Frees the state (the graph is not owned).
+void dyn_free(DynamicSSSP *d);
+
+#endif // DYNSSSP_H
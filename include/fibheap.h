@@ -2,6 +2,8 @@
 #define FIBHEAP_H
 
 #include <stdbool.h>
+#include "heapstats.h"
+#include "memtrack.h"
 
 // Opaque type for the Fibonacci Heap.
 // The implementation is hidden in the .c file.
@@ -32,6 +34,13 @@ int fib_extract_min(FibHeap *H);
  */
 void fib_decrease_key(FibHeap *H, int node, double new_key);
 
+/**
+ * Removes every node from the heap but keeps the node map allocated,
+ * so the heap can be reused for another search without an O(n) calloc.
+ * Cost is proportional to the number of nodes still in the heap.
+ */
+void fib_clear(FibHeap *H);
+
 /**
  * Frees all memory used by the heap.
  */
@@ -42,4 +51,17 @@ void fib_free(FibHeap *H);
  */
 bool fib_is_empty(FibHeap *H);
 
+/**
+ * Copies the operation counters into 'out' and resets them.
+ * Returns 1, or 0 (with 'out' zeroed) if built without HEAP_STATS.
+ */
+int fib_take_stats(FibHeap *H, HeapStats *out);
+
+/**
+ * Copies the heap's allocation counters (node map, nodes and
+ * consolidation scratch since fib_create) into 'out'.
+ * 'peak_objects' is the largest number of nodes held at once.
+ */
+void fib_memory(FibHeap *H, MemCounter *out);
+
 #endif // FIBHEAP_H
\ No newline at end of file
@@ -32,18 +32,36 @@ void generate_edge_case_queries(const char* folder, Graph* g);
 // Returns the count of valid pairs, or -1 on file error.
 int validate_query_file(const char* folder, const char* filename, Graph* g);
 
+// --- Seeded workloads; these write 1-based ids like the rank file ---
 
-// --- Function declarations below are not implemented in the .c file ---
+// Sets the seed of the generators that take none (degree weighted, spatial).
+void set_generator_seed(unsigned int seed);
 
+// Generates a Dijkstra-rank workload ("s t i" lines, target at rank 2^i).
+void generate_rank_queries(const char* folder, Graph* g, int num_sources,
+                           unsigned int seed);
+
+// Generates 'count' uniform random pairs into folder/filename.
 void generate_custom_queries(const char* folder, Graph* g, int count, 
                             const char* filename, unsigned int seed);
 
+// Generates pairs with endpoints weighted by out-degree (or uniform
+// over non-isolated nodes if 'degree_weighted' is 0).
 void generate_degree_weighted_queries(const char* folder, Graph* g, 
                                      int count, int degree_weighted);
 
+// Generates pairs with t within network distance 'max_distance' of s.
 void generate_spatial_queries(const char* folder, Graph* g, int count, 
                              double max_distance);
 
+// Generates pairs with Zipf-distributed sources over 'num_hot' hot nodes.
+void generate_zipf_queries(const char* folder, Graph* g, int count, int num_hot,
+                           double exponent, unsigned int seed);
+
+// Sources whose SSSP analyze_query_file runs.
+#define ANALYZE_SAMPLE_SOURCES 16
+
+// Prints source skew and sampled hop and distance distributions of a query file.
 void analyze_query_file(const char* folder, const char* filename, Graph* g);
 
 #endif /* GENERATE_QUERIES_H */
\ No newline at end of file
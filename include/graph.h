@@ -1,6 +1,8 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "memtrack.h"
+
 // Represents a single directed edge in an adjacency list.
 typedef struct Edge {
     int to;               // Target node index (0-based)
@@ -19,6 +21,9 @@ typedef struct {
     // Reverse adjacency lists (for bidirectional search)
     // rev_adj[i] = list of edges terminating at i
     Edge** rev_adj;
+
+    // Bytes and edges allocated for the lists (not the struct itself)
+    MemCounter mem;
 } Graph;
 
 
@@ -28,6 +33,9 @@ Graph* create_graph(int num_nodes);
 // Adds a single directed edge (u -> v) to the graph's forward list (g->adj).
 void add_edge(Graph* g, int u, int v, double weight);
 
+// Adds a directed arc (u -> v) to both g->adj and g->rev_adj.
+void add_arc(Graph* g, int u, int v, double weight);
+
 /**
  * Loads a graph from a DIMACS file.
  * Parses 'p sp' and 'a' lines. Converts 1-based indices to 0-based.
@@ -35,6 +43,14 @@ void add_edge(Graph* g, int u, int v, double weight);
  */
 Graph* load_dimacs_graph(const char* filename);
 
+/**
+ * Sets the weight of the arc (u -> v) to 'weight'.
+ * Updates both the forward (adj) and the mirrored reverse (rev_adj)
+ * entry so forward and backward searches stay consistent.
+ * Returns 1 if the arc exists, 0 otherwise.
+ */
+int update_edge_weight(Graph* g, int u, int v, double weight);
+
 // Frees all memory associated with the graph, including all edges.
 void free_graph(Graph* g);
 
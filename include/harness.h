@@ -0,0 +1,38 @@
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#include "graph.h"
+
+// Upper limit on repetitions per query (keeps the sample arrays on the stack).
+#define MAX_REPETITIONS 101
+
+// Repetitions farther than this many scaled MADs from the median are outliers.
+#define OUTLIER_MADS 3.0
+
+/**
+ * Pins the calling thread (and threads it creates later) to CPU 'cpu'.
+ * Returns 1 on success, 0 (with a warning) if pinning is not possible.
+ */
+int harness_pin_cpu(int cpu);
+
+/**
+ * Pre-faults the memory a query run uses so page faults do not land in
+ * the timings: walks every arc of 'g', and keeps freed blocks in the
+ * process instead of returning them to the OS (glibc), after touching
+ * one query's working set of 'bytes_per_node' bytes per node once.
+ */
+void harness_prefault(const Graph *g, int bytes_per_node);
+
+/**
+ * Returns the median of 'n' values (sorted in place; mean of the two
+ * middle values for even n). Returns 0 for n == 0.
+ */
+double harness_median(double *v, int n);
+
+/**
+ * Returns the median absolute deviation of 'n' values from 'median'
+ * (unscaled). 'v' is left unchanged.
+ */
+double harness_mad(const double *v, int n, double median);
+
+#endif // HARNESS_H
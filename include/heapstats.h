@@ -0,0 +1,30 @@
+#ifndef HEAPSTATS_H
+#define HEAPSTATS_H
+
+/*
+ * Heap operation counters.
+ *
+ * Compiled in only when HEAP_STATS is defined (make stats). Without it
+ * the heaps carry no counter fields and HEAP_STAT() expands to nothing,
+ * so the normal build pays nothing for the instrumentation.
+ */
+typedef struct {
+    long inserts;             // New nodes (inserts of present nodes count as decrease-keys)
+    long decrease_keys;       // decrease_key calls that lowered a key
+    long decrease_noops;      // decrease_key calls with a key that was not lower
+    long extract_mins;
+    long links;               // Trees linked under another (fib_link, pairing merges)
+    long cuts;                // Nodes cut from their parent by a decrease_key
+    long cascading_cuts;      // Extra cuts from the cascading rule (Fibonacci only)
+    long root_list_total;     // Sum of root list lengths consolidated by extract_min
+    long root_list_max;       // Longest such root list
+    long max_degree;          // Largest child count seen
+} HeapStats;
+
+#ifdef HEAP_STATS
+#define HEAP_STAT(stmt) do { stmt; } while (0)
+#else
+#define HEAP_STAT(stmt) do { } while (0)
+#endif
+
+#endif // HEAPSTATS_H
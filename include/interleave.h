@@ -0,0 +1,31 @@
+#ifndef INTERLEAVE_H
+#define INTERLEAVE_H
+
+#include "graph.h"
+
+// Outcome of one interleaved query, stored at the query's input position.
+typedef struct {
+    double dist;          // Shortest distance (DBL_MAX if unreachable)
+    double latency;       // Wall time from the query's first to its last step
+    int settled;          // Nodes settled before t was reached
+} InterleaveResult;
+
+/**
+ * Answers 'n' point-to-point queries (0-based pairs in 'queries') on the
+ * calling thread with up to 'width' searches in flight.
+ *
+ * Every in-flight query is an explicit state machine (dist array, binary
+ * heap, touched list) that is advanced by one settled node per turn,
+ * round-robin. Before a query takes its turn, the adjacency and distance
+ * lines of the nodes the next two queries will settle are prefetched, so
+ * their cache misses overlap with the current query's work instead of
+ * stalling the core one after another. Each search stops when t is
+ * settled; distances are identical to a plain Dijkstra.
+ *
+ * The 'width' workspaces are allocated once and reset through their
+ * touched lists, so a query costs time proportional to its search space.
+ * 'width' <= 1 runs the queries one after the other.
+ */
+void run_interleaved(const Graph *g, const int *queries, int n, int width, InterleaveResult *results);
+
+#endif // INTERLEAVE_H
@@ -0,0 +1,63 @@
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+#include "graph.h"
+#include "fibheap.h"
+#include "pairingheap.h"
+
+// An arc leaving the range: 'from' is inside, the budget runs out on the arc.
+typedef struct {
+    int from;
+    int to;
+    double weight;
+    double remaining;     // Budget left at 'from' (< weight)
+} BoundaryArc;
+
+/*
+ * Bounded-range (isochrone) search.
+ *
+ * Settles every node within 'budget' of the source and stops as soon as
+ * the heap minimum exceeds the budget. The workspace (heap, labels,
+ * result arrays) is created once and reset through a touched list, so
+ * repeated queries cost time proportional to the area they explore,
+ * not to the size of the graph.
+ *
+ * The result of the last query lives in the workspace until the next
+ * call: 'nodes' lists the settled nodes in ascending distance order
+ * (so the range of any smaller budget is a prefix of it), 'dist' holds
+ * their exact distances.
+ */
+typedef struct {
+    const Graph *g;
+    FibHeap *fib;             // Exactly one of the two heaps is used
+    PairingHeap *pair;
+
+    double *dist;             // Exact for nodes in range, tentative or DBL_MAX elsewhere
+    int *touched;             // Nodes whose label must be reset
+    int num_touched;
+
+    int *nodes;               // Nodes in range, by ascending distance
+    int num_nodes;
+    BoundaryArc *boundary;    // Arcs leaving the range (if requested)
+    int num_boundary;
+    int boundary_cap;
+} RangeSearch;
+
+/**
+ * Creates a workspace for range queries on 'g' with a "fib" or "pair"
+ * heap. Returns NULL for an unknown heap type; exits on allocation
+ * failure.
+ */
+RangeSearch* range_create(const Graph *g, const char *heap_type);
+
+/**
+ * Finds all nodes within distance 'budget' of 's' (inclusive).
+ * If 'with_boundary' is set, also collects the arcs (u, v) with u in
+ * range and dist[u] + w > budget. Returns the number of nodes in range.
+ */
+int range_query(RangeSearch *r, int s, double budget, int with_boundary);
+
+// Frees the workspace (the graph is not owned).
+void range_free(RangeSearch *r);
+
+#endif // ISOCHRONE_H
@@ -0,0 +1,55 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+// The phases of one query, timed separately.
+typedef enum {
+    PHASE_ALLOC,          // Distance array allocation
+    PHASE_INIT,           // Distance array initialization (O(n))
+    PHASE_HEAP_CREATE,    // Heap creation (O(n) node map)
+    PHASE_SEARCH,         // Dijkstra itself
+    PHASE_TEARDOWN,       // Freeing the heap and the distance array
+    NUM_PHASES
+} QueryPhase;
+
+/*
+ * Per-query latency samples, split by phase.
+ *
+ * Every recorded query keeps one sample per phase plus the total, so
+ * the summary can report percentiles, not only averages. Phases are
+ * timed with timer_now() (monotonic, nanosecond resolution).
+ */
+typedef struct {
+    int count;
+    int capacity;
+    double *samples[NUM_PHASES + 1];  // [NUM_PHASES] holds the totals
+} LatencyRecorder;
+
+/**
+ * Creates a recorder for up to 'capacity' queries (it grows if needed).
+ * Exits on allocation failure.
+ */
+LatencyRecorder* latency_create(int capacity);
+
+/**
+ * Records one query. 'phase' holds NUM_PHASES durations in seconds;
+ * the total is their sum.
+ */
+void latency_add(LatencyRecorder *r, const double *phase);
+
+/**
+ * Returns the p-th percentile (0..100, nearest rank) of 'n' samples.
+ * 'values' is sorted in place. Returns 0 for n == 0.
+ */
+double latency_percentile(double *values, int n, double p);
+
+/**
+ * Prints mean, p50, p90, p99 and max per phase and for the total, in
+ * microseconds, and the throughput over 'wall_time' seconds.
+ * Sorts the recorded samples in place.
+ */
+void latency_print(LatencyRecorder *r, double wall_time);
+
+// Frees the recorder.
+void latency_free(LatencyRecorder *r);
+
+#endif // LATENCY_H
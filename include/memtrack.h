@@ -0,0 +1,106 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stdlib.h>
+
+/*
+ * Counting allocator.
+ *
+ * Each owner (the graph, every heap instance, the query driver) keeps
+ * its own MemCounter and allocates through the wrappers below, which
+ * pass the size to free so no per-block header is needed. An owner is
+ * used by one thread at a time, so the counters are plain fields and
+ * cost a few adds per allocation.
+ */
+typedef struct {
+    long long live;           // Bytes currently allocated
+    long long peak;           // Largest 'live' seen
+    long allocs;              // Allocation calls
+    long objects;             // Live fixed-size objects (heap nodes, edges)
+    long peak_objects;        // Largest 'objects' seen
+} MemCounter;
+
+static inline void mem_init(MemCounter *c) {
+    c->live = c->peak = 0;
+    c->allocs = 0;
+    c->objects = c->peak_objects = 0;
+}
+
+static inline void mem_count(MemCounter *c, long long size) {
+    c->live += size;
+    c->allocs++;
+    if (c->live > c->peak) c->peak = c->live;
+}
+
+// malloc counted in 'c'.
+static inline void* mem_malloc(MemCounter *c, size_t size) {
+    void *p = malloc(size);
+    if (p) mem_count(c, (long long)size);
+    return p;
+}
+
+// calloc counted in 'c'.
+static inline void* mem_calloc(MemCounter *c, size_t n, size_t size) {
+    void *p = calloc(n, size);
+    if (p) mem_count(c, (long long)n * size);
+    return p;
+}
+
+// realloc of a block of 'old_size' bytes counted in 'c'.
+static inline void* mem_realloc(MemCounter *c, void *p, size_t old_size, size_t size) {
+    void *q = realloc(p, size);
+    if (q) {
+        c->live -= (long long)old_size;
+        mem_count(c, (long long)size);
+    }
+    return q;
+}
+
+// Frees a block of 'size' bytes allocated through 'c'.
+static inline void mem_free(MemCounter *c, void *p, size_t size) {
+    if (!p) return;
+    c->live -= (long long)size;
+    free(p);
+}
+
+// mem_malloc of one fixed-size object (also counted in 'objects').
+static inline void* mem_new_object(MemCounter *c, size_t size) {
+    void *p = mem_malloc(c, size);
+    if (p && ++c->objects > c->peak_objects) c->peak_objects = c->objects;
+    return p;
+}
+
+// Frees an object allocated with mem_new_object.
+static inline void mem_free_object(MemCounter *c, void *p, size_t size) {
+    if (!p) return;
+    c->objects--;
+    mem_free(c, p, size);
+}
+
+/*
+ * Exit-on-failure allocators for workspaces that are not counted: they
+ * print the failed size and exit instead of returning NULL. Every module
+ * uses these rather than checking malloc results itself.
+ */
+void* xmalloc(size_t size);
+void* xcalloc(size_t n, size_t size);
+void* xrealloc(void *p, size_t size);
+
+/**
+ * Returns the peak resident set size of the process in KiB since start
+ * or since the last successful mem_reset_peak_rss(), or -1 if unknown.
+ */
+long mem_peak_rss_kb(void);
+
+/**
+ * Resets the peak RSS to the current RSS (Linux 4.0+). Returns 1 on
+ * success, 0 if the peak can only grow on this system.
+ */
+int mem_reset_peak_rss(void);
+
+/**
+ * Returns the installed physical memory in bytes, or 0 if unknown.
+ */
+long long mem_physical_bytes(void);
+
+#endif // MEMTRACK_H
@@ -0,0 +1,29 @@
+#ifndef MULTISOURCE_H
+#define MULTISOURCE_H
+
+#include "graph.h"
+
+// Number of sources handled by one multi-source search.
+#define MS_LANES 8
+
+/**
+ * Multi-source Dijkstra: up to MS_LANES full SSSPs in one traversal.
+ *
+ * Every node holds a vector of MS_LANES tentative distances (one lane
+ * per source). Arcs are relaxed for all lanes at once with a vector
+ * add and min (GCC vector extensions, plain loops elsewhere). A single
+ * pairing heap orders nodes by the smallest lane that improved, so a
+ * node can be scanned more than once (label-correcting), but the graph
+ * is read once per scan for all sources instead of once per source.
+ * The saving is largest when the sources are close to each other;
+ * for sources spread over the whole graph most nodes are scanned
+ * about once per lane.
+ *
+ * 'dist[i]' must point to a caller-owned array of g->num_nodes doubles;
+ * it receives the distances from sources[i] (DBL_MAX if unreachable).
+ * 'k' must be between 1 and MS_LANES. Invalid sources give all-DBL_MAX
+ * rows. Returns the number of node scans (heap extractions).
+ */
+long dijkstra_multi(const Graph *g, const int *sources, int k, double **dist);
+
+#endif // MULTISOURCE_H
@@ -2,6 +2,9 @@
 #ifndef PAIRINGHEAP_H
 #define PAIRINGHEAP_H
 
+#include "heapstats.h"
+#include "memtrack.h"
+
 // Represents a node within the Pairing Heap.
 typedef struct PairNode {
     double key;           // Priority (distance)
@@ -21,6 +24,10 @@ typedef struct {
     PairNode **map;
     
     int n;              // Max number of nodes (size of the map)
+    MemCounter mem;     // Bytes allocated by this heap (see memtrack.h)
+#ifdef HEAP_STATS
+    HeapStats stats;    // Operation counters (see heapstats.h)
+#endif
 } PairingHeap;
 
 /**
@@ -47,6 +54,25 @@ int pair_extract_min(PairingHeap *h);
  */
 void pair_decrease_key(PairingHeap *h, int val, double newKey);
 
+/**
+ * Removes every node from the heap but keeps the node map allocated,
+ * so the heap can be reused for another search without an O(n) calloc.
+ * Cost is proportional to the number of nodes still in the heap.
+ */
+void pair_clear(PairingHeap *h);
+
+/**
+ * Copies the operation counters into 'out' and resets them.
+ * Returns 1, or 0 (with 'out' zeroed) if built without HEAP_STATS.
+ */
+int pair_take_stats(PairingHeap *h, HeapStats *out);
+
+/**
+ * Copies the heap's allocation counters (node map, nodes and merge
+ * scratch since pair_create) into 'out'; same contract as fib_memory.
+ */
+void pair_memory(PairingHeap *h, MemCounter *out);
+
 /**
  * Frees all memory used by the heap.
  */
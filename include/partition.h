@@ -0,0 +1,32 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "graph.h"
+
+/**
+ * A nested multi-level partition of the graph's nodes.
+ * Level 0 is the finest level; every level-l cell is the union
+ * of whole level-(l-1) cells. The partition only looks at the
+ * graph topology, never at Edge.weight, so it stays valid when
+ * weights change.
+ */
+typedef struct {
+    int num_levels;       // Number of nested levels
+    int *num_cells;       // num_cells[l] = number of cells on level l
+    int **cell;           // cell[l][v] = cell id of node v on level l
+} Partition;
+
+/**
+ * Partitions 'g' into 'num_levels' nested levels.
+ * 'cell_sizes[l]' is the maximum number of nodes in a level-l cell;
+ * sizes must be increasing. Cells are grown by BFS over the undirected
+ * view of the graph (adj + rev_adj), and small leftover fragments are
+ * merged into a neighbouring cell when the result still fits.
+ * Exits on allocation failure.
+ */
+Partition* partition_graph(const Graph *g, int num_levels, const int *cell_sizes);
+
+// Frees all memory associated with the partition.
+void free_partition(Partition *p);
+
+#endif // PARTITION_H
@@ -0,0 +1,55 @@
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdint.h>
+
+// Hardware events counted by a PerfGroup, in this order.
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,      // L1 data cache read misses
+    PERF_LLC_MISSES,      // Last-level cache read misses
+    PERF_DTLB_MISSES,     // Data TLB read misses
+    PERF_BRANCH_MISSES,
+    PERF_NUM_EVENTS
+} PerfEvent;
+
+/*
+ * Hardware performance counters around a code region (Linux
+ * perf_event_open, user space only).
+ *
+ * The events are opened as one group so they are scheduled together.
+ * Events the CPU, hypervisor or kernel policy (perf_event_paranoid)
+ * does not allow are skipped; if none can be opened, perf_open returns
+ * NULL and callers run without counters. On other platforms perf_open
+ * always returns NULL.
+ */
+typedef struct {
+    int fd[PERF_NUM_EVENTS];  // -1 for events that could not be opened
+    int leader;               // fd of the group leader
+    int num_open;
+} PerfGroup;
+
+/**
+ * Opens the event group for the calling thread. Returns NULL (after
+ * printing the reason to stderr) if no event is available.
+ */
+PerfGroup* perf_open(void);
+
+// Resets and starts all counters of the group.
+void perf_start(PerfGroup *p);
+
+/**
+ * Stops the counters and stores their values in 'values'
+ * (PERF_NUM_EVENTS entries, scaled if the group was multiplexed).
+ * Events that are not open read as UINT64_MAX.
+ */
+void perf_stop(PerfGroup *p, uint64_t *values);
+
+// Short name of an event, e.g. "cycles".
+const char* perf_event_name(int event);
+
+// Closes all events and frees the group.
+void perf_close(PerfGroup *p);
+
+#endif // PERFCOUNT_H
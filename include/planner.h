@@ -0,0 +1,28 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+/*
+ * Query execution planner.
+ *
+ * Groups the (s, t) pairs of a query file by source so that one
+ * multi-target search can answer every pair that shares a source.
+ * Groups are ordered by source id; inside a group the original
+ * query order is kept.
+ */
+typedef struct {
+    int num_queries;      // Number of (s, t) pairs planned
+    int num_groups;       // Number of distinct sources (= searches needed)
+    int *order;           // Query indices, grouped by source
+    int *group_start;     // Group k is order[group_start[k] .. group_start[k+1])
+} QueryPlan;
+
+/**
+ * Builds a plan for 'n' 0-based query pairs (queries[2i], queries[2i+1]).
+ * Exits on allocation failure.
+ */
+QueryPlan* plan_by_source(const int *queries, int n);
+
+// Frees all memory associated with the plan.
+void free_query_plan(QueryPlan *p);
+
+#endif // PLANNER_H
@@ -0,0 +1,70 @@
+#ifndef RUNLOG_H
+#define RUNLOG_H
+
+#include <stdio.h>
+#include "latency.h"
+
+// What a query file run measured, written as metadata with every record.
+typedef struct {
+    const char *graph_file;
+    int num_nodes;
+    long num_edges;
+    const char *query_file;
+    const char *heap_type;
+    double timeout;           // Per-query limits (0 = none)
+    long max_settled;
+} RunInfo;
+
+// Outcome of one query.
+typedef enum {
+    RUN_OK,
+    RUN_UNREACHABLE,
+    RUN_TIMEOUT
+} RunStatus;
+
+/*
+ * Machine-readable results of a query file run, for comparing runs
+ * across commits and hosts (see compare_runs).
+ *
+ * Two files are written side by side:
+ *   CSV  - "# key=value" metadata lines (host, build, heap, ...), a
+ *          header line, then one row per query with the phase times in
+ *          seconds and any counters. Readers look columns up by name.
+ *   JSON - the same metadata, one object per query and a summary.
+ * Counters that were not measured are left empty (CSV) or null (JSON).
+ */
+typedef struct {
+    FILE *csv;
+    FILE *json;
+    int num_counters;
+    int rows;
+    int reachable;
+    int timeouts;
+    double total_time;
+} RunLog;
+
+/**
+ * Creates both files and writes the metadata and the CSV header.
+ * 'counter_names' names the 'num_counters' values passed to runlog_add
+ * (may be 0). Returns NULL (with a warning) if a file cannot be created.
+ */
+RunLog* runlog_open(const char *csv_path, const char *json_path, const RunInfo *info,
+                    const char **counter_names, int num_counters);
+
+/**
+ * Records one query: 1-based ids, its status, distance (ignored unless
+ * RUN_OK), NUM_PHASES phase times and the counters (-1 = not counted).
+ */
+void runlog_add(RunLog *log, int s, int t, RunStatus status, double dist,
+                const double *phase, const long long *counters);
+
+// Writes the summary, closes both files and frees the log.
+void runlog_close(RunLog *log, double wall_time);
+
+// Host name of this machine ("unknown" if it cannot be read).
+const char* runlog_host(void);
+
+// Compiler and the build options that affect timings, e.g. "gcc 13.2.0, optimized, openmp".
+const char* runlog_build(void);
+
+#endif // RUNLOG_H
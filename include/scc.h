@@ -0,0 +1,65 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Answers of scc_query.
+#define SCC_UNREACHABLE 0
+#define SCC_REACHABLE   1
+#define SCC_UNKNOWN     (-1)
+
+/*
+ * Strongly connected component index.
+ *
+ * Components are numbered by Tarjan's algorithm in reverse topological
+ * order of the condensation DAG: an arc between two components always
+ * goes from a higher to a lower id. On top of that the index stores
+ * each component's level in the DAG (longest path to a sink) and
+ * whether it is reachable from / can reach the largest component,
+ * which on road graphs holds nearly every node.
+ */
+typedef struct {
+    int num_nodes;
+    long num_edges;       // Arc count of the graph the index was built for
+    uint64_t arc_hash;    // Checksum of that graph's arcs (tails, heads, weights)
+    int num_comps;
+    int giant;            // Id of the largest component
+    int giant_size;
+    int *comp;            // comp[v] = component id
+    int *level;           // level[c] = longest condensation path from c to a sink
+    unsigned char *flags; // SCC_FROM_GIANT | SCC_TO_GIANT per component
+} SccIndex;
+
+#define SCC_FROM_GIANT 1  // Reachable from the giant component
+#define SCC_TO_GIANT   2  // Can reach the giant component
+
+/**
+ * Computes the SCCs of 'g' with an iterative Tarjan over g->adj and
+ * derives the condensation data. Exits on allocation failure.
+ */
+SccIndex* scc_build(const Graph *g);
+
+/**
+ * Loads the index from 'path' if it exists and was built for a graph
+ * with the same node and arc counts and the same arc checksum as 'g'
+ * (so an edited graph file is detected). Otherwise builds it and tries
+ * to save it to 'path' (a failed save only prints a warning).
+ */
+SccIndex* scc_load_or_build(const Graph *g, const char *path);
+
+// Writes the index to 'path' in binary form. Returns 0 on success.
+int scc_save(const SccIndex *x, const char *path);
+
+/**
+ * O(1) reachability test for the pair (s, t).
+ * Returns SCC_REACHABLE, SCC_UNREACHABLE, or SCC_UNKNOWN when the
+ * index cannot decide (both endpoints in small components that are
+ * not connected through the giant one). Invalid ids are unreachable.
+ */
+int scc_query(const SccIndex *x, int s, int t);
+
+// Frees all memory associated with the index.
+void free_scc_index(SccIndex *x);
+
+#endif // SCC_H
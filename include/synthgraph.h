@@ -0,0 +1,96 @@
+#ifndef SYNTHGRAPH_H
+#define SYNTHGRAPH_H
+
+#include <stddef.h>
+#include "graph.h"
+
+// Families of synthetic graphs.
+typedef enum {
+    SYNTH_GRID,           // 2D grid, 4-neighbour, random weights (road-like)
+    SYNTH_RGG,            // Random geometric graph, Euclidean weights
+    SYNTH_GNM,            // Erdos-Renyi G(n, m), random weights
+    SYNTH_RMAT,           // R-MAT power-law graph, random weights
+    SYNTH_NUM_KINDS
+} SynthKind;
+
+// Parameters of one synthetic graph.
+typedef struct {
+    SynthKind kind;
+    int n;                // Node count (grid: rounded to a square)
+    double degree;        // Average out-degree (grid: always about 4)
+    int max_weight;       // Integer weights in [1, max_weight] (not RGG)
+    unsigned long long seed;
+    int threads;          // Generator threads, <= 0 = OpenMP default
+} SynthParams;
+
+// Returns the name of 'kind' ("grid", "rgg", "gnm", "rmat").
+const char* synth_kind_name(SynthKind kind);
+
+/**
+ * Fills 'p' with the defaults for 'kind' and 'n' nodes: degree 4 for
+ * grid and G(n, m), 6 for RGG and 16 for R-MAT, weights up to 1000,
+ * seed 1 and the default thread count.
+ */
+void synth_defaults(SynthKind kind, int n, SynthParams *p);
+
+/**
+ * Parses a graph spec "kind:n[:degree[:seed]]" (e.g. "grid:1e6",
+ * "rmat:1048576:16:7") into 'p'. Returns 1 on success, 0 if 'spec' is
+ * not a synthetic graph spec (so it can be tried as a file name).
+ */
+int synth_parse(const char *spec, SynthParams *p);
+
+/**
+ * Estimates the bytes needed to generate the graph of 'p': the graph
+ * itself (two list heads per node, two edge nodes per arc with malloc
+ * overhead) plus the generator's temporary arc buffer.
+ */
+size_t synth_estimate_bytes(const SynthParams *p);
+
+/**
+ * Generates the graph described by 'p' with both adjacency lists filled,
+ * like load_dimacs_graph. The same parameters always give the same graph,
+ * whatever the thread count: arcs are drawn in parallel from per-block
+ * random streams and then inserted in a fixed order.
+ * Exits on allocation failure.
+ */
+Graph* synth_generate(const SynthParams *p);
+
+/**
+ * A rows x cols grid; each pair of horizontal or vertical neighbours is
+ * joined by arcs in both directions with one weight drawn uniformly from
+ * [1, max_weight].
+ */
+Graph* synth_grid(int rows, int cols, int max_weight, unsigned long long seed, int threads);
+
+/**
+ * 'n' points uniform in a 10^6 x 10^6 square; points closer than the
+ * radius that gives an expected 'degree' neighbours are joined in both
+ * directions with weight 1 + floor(distance). Nodes are numbered in
+ * spatial cell order, so neighbours tend to have nearby ids (as in road
+ * networks).
+ */
+Graph* synth_rgg(int n, double degree, unsigned long long seed, int threads);
+
+/**
+ * 'm' directed arcs with both endpoints uniform (no self loops, parallel
+ * arcs possible) and weights uniform in [1, max_weight].
+ */
+Graph* synth_gnm(int n, long m, int max_weight, unsigned long long seed, int threads);
+
+/**
+ * 'm' directed R-MAT arcs (Graph500 probabilities a=0.57, b=c=0.19)
+ * over 'n' nodes, with node ids randomly permuted so high-degree nodes
+ * are not clustered at small ids. Weights are uniform in [1, max_weight].
+ */
+Graph* synth_rmat(int n, long m, int max_weight, unsigned long long seed, int threads);
+
+/**
+ * Fills src[0..count-1] with node ids uniform over all of 'g' (retrying
+ * up to 100 times to avoid nodes without outgoing arcs), drawn from a
+ * splitmix stream of 'seed', so the same seed gives the same sources on
+ * every platform. 'g' must have at least one node.
+ */
+void synth_sources(const Graph *g, int count, unsigned long long seed, int *src);
+
+#endif // SYNTHGRAPH_H
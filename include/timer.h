@@ -0,0 +1,18 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+/**
+ * Returns a monotonic wall-clock timestamp in seconds.
+ * Unlike clock(), this measures elapsed time rather than CPU time,
+ * so it stays meaningful when work is spread over several threads.
+ */
+double timer_now(void);
+
+/**
+ * Returns the CPU time consumed by the calling thread, in seconds.
+ * Time the thread spends descheduled is not counted, so per-query
+ * numbers stay comparable when more threads than cores are running.
+ */
+double timer_thread_cpu(void);
+
+#endif // TIMER_H
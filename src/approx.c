@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "approx.h"
+#include "memtrack.h"
+
+// One ring slot: a stack of node ids (stale entries are skipped on pop).
+struct ApproxBucket {
+    int *items;
+    int n;
+    int cap;
+};
+
+ApproxSearch* approx_create(const Graph *g, double eps, ApproxWidth rule) {
+    int n = g->num_nodes;
+    if (eps < 0) eps = 0;
+
+    // Weight range of the graph (zero-weight arcs do not bound the width)
+    double w_min = DBL_MAX, w_max = 0, w_sum = 0;
+    long positive = 0;
+    for (int u = 0; u < n; u++) {
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            if (e->weight > 0) {
+                if (e->weight < w_min) w_min = e->weight;
+                w_sum += e->weight;
+                positive++;
+            }
+            if (e->weight > w_max) w_max = e->weight;
+        }
+    }
+    if (w_min == DBL_MAX) w_min = 1.0;
+    double w_mean = positive > 0 ? w_sum / positive : w_min;
+
+    ApproxSearch *a = xmalloc(sizeof(ApproxSearch));
+    a->g = g;
+    a->eps = eps;
+    a->rule = rule;
+    if (rule == APPROX_WIDTH_MEAN) {
+        a->width = w_min + eps * w_mean;
+        a->bound = eps * w_mean / w_min;
+    } else {
+        a->width = (1 + eps) * w_min;
+        a->bound = eps;
+    }
+    // Live entries span at most buckets [cur, cur + w_max / width + 1]
+    a->num_buckets = (int)(w_max / a->width) + 2;
+    a->ring = xmalloc(a->num_buckets * sizeof(struct ApproxBucket));
+    for (int i = 0; i < a->num_buckets; i++) {
+        a->ring[i].items = NULL;
+        a->ring[i].n = 0;
+        a->ring[i].cap = 0;
+    }
+
+    a->dist = xmalloc(n * sizeof(double));
+    a->settled = xcalloc(n > 0 ? n : 1, 1);
+    a->touched = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; i++) a->dist[i] = DBL_MAX;
+    a->num_touched = 0;
+    a->used_cap = 1024;
+    a->used = xmalloc(a->used_cap * sizeof(int));
+    a->num_used = 0;
+    return a;
+}
+
+static void bucket_push(ApproxSearch *a, long index, int v) {
+    int slot = (int)(index % a->num_buckets);
+    struct ApproxBucket *b = &a->ring[slot];
+    if (b->n == 0) {
+        if (a->num_used == a->used_cap) {
+            a->used_cap *= 2;
+            a->used = xrealloc(a->used, a->used_cap * sizeof(int));
+        }
+        a->used[a->num_used++] = slot;
+    }
+    if (b->n == b->cap) {
+        b->cap = b->cap ? b->cap * 2 : 16;
+        b->items = xrealloc(b->items, b->cap * sizeof(int));
+    }
+    b->items[b->n++] = v;
+}
+
+// Clears the labels and ring slots left behind by the previous search.
+static void approx_reset(ApproxSearch *a) {
+    for (int i = 0; i < a->num_touched; i++) {
+        int v = a->touched[i];
+        a->dist[v] = DBL_MAX;
+        a->settled[v] = 0;
+    }
+    a->num_touched = 0;
+    for (int i = 0; i < a->num_used; i++) a->ring[a->used[i]].n = 0;
+    a->num_used = 0;
+}
+
+double approx_query(ApproxSearch *a, int s, int t, int *settled) {
+    const Graph *g = a->g;
+    approx_reset(a);
+    if (settled) *settled = 0;
+    if (s < 0 || s >= g->num_nodes) return DBL_MAX;
+
+    double *dist = a->dist;
+    a->dist[s] = 0.0;
+    a->touched[a->num_touched++] = s;
+    bucket_push(a, 0, s);
+
+    long pending = 1;     // Entries in the ring, including stale ones
+    long cur = 0;         // Absolute index of the current bucket
+    int count = 0;
+    double result = DBL_MAX;
+
+    while (pending > 0) {
+        struct ApproxBucket *b = &a->ring[cur % a->num_buckets];
+        if (b->n == 0) {
+            cur++;
+            continue;
+        }
+        int u = b->items[--b->n];
+        pending--;
+        if (a->settled[u]) continue;
+
+        // Final label: u is never reopened, even if a shorter path shows up
+        a->settled[u] = 1;
+        count++;
+        if (u == t) {
+            result = dist[u];
+            break;
+        }
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            if (a->settled[v]) continue;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                if (dist[v] == DBL_MAX) a->touched[a->num_touched++] = v;
+                dist[v] = nd;
+                bucket_push(a, (long)(nd / a->width), v);
+                pending++;
+            }
+        }
+    }
+
+    if (settled) *settled = count;
+    return result;
+}
+
+void approx_free(ApproxSearch *a) {
+    if (!a) return;
+    for (int i = 0; i < a->num_buckets; i++) free(a->ring[i].items);
+    free(a->ring);
+    free(a->dist);
+    free(a->settled);
+    free(a->touched);
+    free(a->used);
+    free(a);
+}
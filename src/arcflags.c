@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "arcflags.h"
+#include "memtrack.h"
+#include "partition.h"
+#include "fibheap.h"
+
+/**
+ * Dijkstra on the reverse graph: dist[x] = shortest distance x -> b.
+ * 'dist' must hold n entries; 'H' must be empty.
+ */
+static void backward_dijkstra(const Graph *g, int b, double *dist, FibHeap *H) {
+    for (int i = 0; i < g->num_nodes; i++) dist[i] = DBL_MAX;
+    dist[b] = 0.0;
+    fib_insert(H, 0.0, b);
+
+    while (!fib_is_empty(H)) {
+        int u = fib_extract_min(H);
+        for (Edge *e = g->rev_adj[u]; e; e = e->next) {
+            double nd = dist[u] + e->weight;
+            if (nd < dist[e->to]) {
+                dist[e->to] = nd;
+                fib_decrease_key(H, e->to, nd);
+            }
+        }
+    }
+}
+
+ArcFlags* arcflags_build(const Graph *g, int num_regions) {
+    int n = g->num_nodes;
+    ArcFlags *af = xmalloc(sizeof(ArcFlags));
+
+    // 1. Regions: a single-level partition with cells of about n / k nodes
+    if (num_regions < 1) num_regions = 1;
+    int cell_size = (n + num_regions - 1) / num_regions;
+    Partition *p = partition_graph(g, 1, &cell_size);
+    af->num_regions = p->num_cells[0];
+    af->words = (af->num_regions + 63) / 64;
+    af->region = p->cell[0];
+    p->cell[0] = NULL; // Take ownership of the labels
+    free_partition(p);
+
+    // 2. Arc ids in adjacency-list order
+    af->offset = xmalloc((n + 1) * sizeof(long));
+    af->offset[0] = 0;
+    for (int u = 0; u < n; u++) {
+        long deg = 0;
+        for (Edge *e = g->adj[u]; e; e = e->next) deg++;
+        af->offset[u + 1] = af->offset[u] + deg;
+    }
+
+    af->num_arcs = af->offset[n];
+    size_t bytes = (size_t)(af->num_arcs > 0 ? af->num_arcs : 1) * af->words * sizeof(unsigned long long);
+    af->flags = xmalloc(bytes);
+    memset(af->flags, 0, bytes);
+
+    // 3. Arcs inside a region always carry its flag
+    //    (covers the part of a shortest path after its last entry into the region)
+    for (int u = 0; u < n; u++) {
+        long arc = af->offset[u];
+        for (Edge *e = g->adj[u]; e; e = e->next, arc++) {
+            int r = af->region[e->to];
+            if (af->region[u] == r)
+                af->flags[arc * af->words + (r >> 6)] |= 1ULL << (r & 63);
+        }
+    }
+
+    // Boundary nodes: nodes with an incoming arc from another region
+    int *boundary = xmalloc(n * sizeof(int));
+    int num_boundary = 0;
+    for (int v = 0; v < n; v++) {
+        for (Edge *e = g->rev_adj[v]; e; e = e->next) {
+            if (af->region[e->to] != af->region[v]) {
+                boundary[num_boundary++] = v;
+                break;
+            }
+        }
+    }
+
+    // 4. One backward search per boundary node b of region r:
+    //    arc (u, v) lies on a shortest path to b iff d(u) == w(u, v) + d(v).
+    #pragma omp parallel
+    {
+        double *dist = xmalloc(n * sizeof(double));
+        FibHeap *H = fib_create(n);
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < num_boundary; i++) {
+            int b = boundary[i];
+            int r = af->region[b];
+            int w = r >> 6;
+            unsigned long long bit = 1ULL << (r & 63);
+            backward_dijkstra(g, b, dist, H);
+
+            for (int u = 0; u < n; u++) {
+                if (dist[u] == DBL_MAX) continue;
+                long arc = af->offset[u];
+                for (Edge *e = g->adj[u]; e; e = e->next, arc++) {
+                    double dv = dist[e->to];
+                    if (dv == DBL_MAX) continue;
+                    // Relative tolerance keeps ties that differ only by rounding
+                    double via = dv + e->weight;
+                    if (dist[u] < via - 1e-9 * via) continue;
+                    unsigned long long *word = &af->flags[arc * af->words + w];
+                    unsigned long long cur;
+                    #pragma omp atomic read
+                    cur = *word;
+                    if (!(cur & bit)) {
+                        #pragma omp atomic
+                        *word |= bit;
+                    }
+                }
+            }
+        }
+
+        fib_free(H);
+        free(dist);
+    }
+
+    free(boundary);
+    return af;
+}
+
+long arcflags_bytes(const ArcFlags *af) {
+    return af->num_arcs * af->words * (long)sizeof(unsigned long long);
+}
+
+void free_arcflags(ArcFlags *af) {
+    if (!af) return;
+    free(af->region);
+    free(af->offset);
+    free(af->flags);
+    free(af);
+}
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "batch.h"
+#include "memtrack.h"
+#include "dijkstra.h"
+#include "timer.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * A worker's share of the batch: query indices [head, tail).
+ * The owner takes from the head, thieves take from the tail.
+ */
+typedef struct {
+    int head;
+    int tail;
+#ifdef _OPENMP
+    omp_lock_t lock;
+#endif
+    char pad[64];         // Keep deques of different workers on separate cache lines
+} WorkDeque;
+
+static void deque_lock(WorkDeque *d) {
+#ifdef _OPENMP
+    omp_set_lock(&d->lock);
+#else
+    (void)d;
+#endif
+}
+
+static void deque_unlock(WorkDeque *d) {
+#ifdef _OPENMP
+    omp_unset_lock(&d->lock);
+#else
+    (void)d;
+#endif
+}
+
+// Takes the next query from the worker's own deque. Returns -1 if empty.
+static int deque_pop(WorkDeque *d) {
+    int q = -1;
+    deque_lock(d);
+    if (d->head < d->tail) q = d->head++;
+    deque_unlock(d);
+    return q;
+}
+
+/**
+ * Moves half of the victim's remaining queries (from its tail) into
+ * the thief's deque. Returns the number of queries moved.
+ */
+static int deque_steal(WorkDeque *victim, WorkDeque *thief) {
+    int lo = 0, hi = 0;
+    deque_lock(victim);
+    int left = victim->tail - victim->head;
+    if (left > 0) {
+        int take = (left + 1) / 2;
+        hi = victim->tail;
+        lo = hi - take;
+        victim->tail = lo;
+    }
+    deque_unlock(victim);
+    if (hi == lo) return 0;
+
+    deque_lock(thief);
+    thief->head = lo;
+    thief->tail = hi;
+    deque_unlock(thief);
+    return hi - lo;
+}
+
+int run_query_batch(const Graph *g, const int *queries, int n, const char *heap_type,
+                    int num_threads, BatchResult *results, BatchStats *stats) {
+    int use_pair;
+    if (strcmp(heap_type, "fib") == 0) use_pair = 0;
+    else if (strcmp(heap_type, "pair") == 0) use_pair = 1;
+    else return -1;
+
+#ifdef _OPENMP
+    int nt = (num_threads > 0) ? num_threads : omp_get_max_threads();
+#else
+    int nt = 1;
+    (void)num_threads;
+#endif
+    if (nt > n && n > 0) nt = n;
+    if (nt < 1) nt = 1;
+
+    // Contiguous initial split: worker w gets [w*n/nt, (w+1)*n/nt)
+    WorkDeque *dq = xmalloc(nt * sizeof(WorkDeque));
+    for (int w = 0; w < nt; w++) {
+        dq[w].head = (int)((long)w * n / nt);
+        dq[w].tail = (int)((long)(w + 1) * n / nt);
+#ifdef _OPENMP
+        omp_init_lock(&dq[w].lock);
+#endif
+    }
+
+    long steals = 0, stolen = 0;
+    double start = timer_now();
+
+    #pragma omp parallel num_threads(nt) reduction(+:steals, stolen)
+    {
+#ifdef _OPENMP
+        int tid = omp_get_thread_num();
+#else
+        int tid = 0;
+#endif
+        // Per-worker workspace, reused for every query this worker runs
+        double *dist = xmalloc(g->num_nodes * sizeof(double));
+        FibHeap *fh = use_pair ? NULL : fib_create(g->num_nodes);
+        PairingHeap *ph = use_pair ? pair_create(g->num_nodes) : NULL;
+
+        while (1) {
+            int qi = deque_pop(&dq[tid]);
+            if (qi < 0) {
+                // Own deque is empty: try every other worker once
+                int got = 0;
+                for (int k = 1; k < nt && !got; k++) {
+                    got = deque_steal(&dq[(tid + k) % nt], &dq[tid]);
+                }
+                if (!got) break; // No work left anywhere (no new work is ever created)
+                steals++;
+                stolen += got;
+                continue;
+            }
+
+            int s = queries[qi * 2];
+            int t = queries[qi * 2 + 1];
+            BatchResult *r = &results[qi];
+            r->worker = tid;
+
+            if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) {
+                r->dist = DBL_MAX;
+                r->latency = 0;
+                r->cpu_time = 0;
+                continue;
+            }
+
+            double st = timer_now();
+            double ct = timer_thread_cpu();
+            if (use_pair) dijkstra_pair_ws(g, s, dist, ph);
+            else dijkstra_fib_ws(g, s, dist, fh);
+            r->cpu_time = timer_thread_cpu() - ct;
+            r->latency = timer_now() - st;
+            r->dist = dist[t];
+        }
+
+        if (fh) fib_free(fh);
+        if (ph) pair_free(ph);
+        free(dist);
+    }
+
+    double wall = timer_now() - start;
+
+#ifdef _OPENMP
+    for (int w = 0; w < nt; w++) omp_destroy_lock(&dq[w].lock);
+#endif
+    free(dq);
+
+    if (stats) {
+        stats->wall_time = wall;
+        stats->num_workers = nt;
+        stats->steals = steals;
+        stats->stolen = stolen;
+    }
+    return 0;
+}
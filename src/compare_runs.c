@@ -0,0 +1,355 @@
+/*
+ * compare_runs: compares two benchmark runs written by run_query_test
+ * ("x_<heap>.csv" run logs) and flags statistically significant
+ * slowdowns per heap and per query file.
+ *
+ * The statistic is the ratio of the mean query time (candidate /
+ * baseline) with a 95% bootstrap confidence interval. If both runs hold
+ * the same queries in the same order the bootstrap resamples query
+ * pairs (paired); otherwise each run is resampled on its own.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+// One run log: its metadata and the total time of every query.
+typedef struct {
+    char host[256];
+    char build[256];
+    char heap[64];
+    int n;
+    int *s, *t;
+    double *total;
+} RunData;
+
+// Result of one comparison.
+typedef enum { SAME, SLOWER, FASTER } Verdict;
+
+static unsigned long long rng_state;
+
+// splitmix64
+static unsigned long long rng_next(void) {
+    unsigned long long z = (rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int is_directory(const char *path) {
+    struct stat statbuf;
+    if (stat(path, &statbuf) != 0) return 0;
+    return S_ISDIR(statbuf.st_mode);
+}
+
+// Copies 'value' into 'dst' if 'line' is "# <key>=value".
+static void read_meta(const char *line, const char *key, char *dst, size_t size) {
+    size_t klen = strlen(key);
+    if (strncmp(line + 2, key, klen) != 0 || line[2 + klen] != '=') return;
+    snprintf(dst, size, "%s", line + 3 + klen);
+    dst[strcspn(dst, "\r\n")] = '\0';
+}
+
+// Returns the index of column 'name' in a CSV header line, or -1.
+static int find_column(const char *header, const char *name) {
+    size_t len = strlen(name);
+    int col = 0;
+    for (const char *p = header; ; col++) {
+        size_t flen = strcspn(p, ",\r\n");
+        if (flen == len && strncmp(p, name, len) == 0) return col;
+        if (p[flen] != ',') return -1;
+        p += flen + 1;
+    }
+}
+
+// Returns the start of field 'col' of a CSV line (fields may be empty).
+static const char* field(const char *line, int col) {
+    for (; col > 0; col--) {
+        line = strchr(line, ',');
+        if (!line) return "";
+        line++;
+    }
+    return line;
+}
+
+/**
+ * Returns 1 if 'path' has a run log header: after the "# key=value"
+ * lines, a CSV header with s, t and total_s columns. Other CSV files
+ * (sweep or heap_bench results) return 0.
+ */
+static int has_run_log_header(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    char line[4096];
+    int ok = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') continue;
+        ok = find_column(line, "s") >= 0 && find_column(line, "t") >= 0 &&
+             find_column(line, "total_s") >= 0;
+        break;
+    }
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * Loads a run log. Returns 1 on success, 0 (with a message) if the file
+ * cannot be read or has no s, t and total_s columns.
+ */
+static int load_run(const char *path, RunData *r) {
+    memset(r, 0, sizeof(RunData));
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 0;
+    }
+
+    char line[4096];
+    int col_s = -1, col_t = -1, col_total = -1;
+    int cap = 1024;
+    r->s = malloc(cap * sizeof(int));
+    r->t = malloc(cap * sizeof(int));
+    r->total = malloc(cap * sizeof(double));
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') {
+            read_meta(line, "host", r->host, sizeof(r->host));
+            read_meta(line, "build", r->build, sizeof(r->build));
+            read_meta(line, "heap", r->heap, sizeof(r->heap));
+            continue;
+        }
+        if (col_total < 0) {
+            col_s = find_column(line, "s");
+            col_t = find_column(line, "t");
+            col_total = find_column(line, "total_s");
+            if (col_s < 0 || col_t < 0 || col_total < 0) break;
+            continue;
+        }
+        if (r->n == cap) {
+            cap *= 2;
+            r->s = realloc(r->s, cap * sizeof(int));
+            r->t = realloc(r->t, cap * sizeof(int));
+            r->total = realloc(r->total, cap * sizeof(double));
+        }
+        r->s[r->n] = atoi(field(line, col_s));
+        r->t[r->n] = atoi(field(line, col_t));
+        r->total[r->n] = atof(field(line, col_total));
+        r->n++;
+    }
+    fclose(fp);
+    if (col_total < 0) {
+        fprintf(stderr, "%s is not a run log (no s, t and total_s columns)\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static void free_run(RunData *r) {
+    free(r->s);
+    free(r->t);
+    free(r->total);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double mean(const double *v, int n) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += v[i];
+    return n > 0 ? sum / n : 0;
+}
+
+/**
+ * Bootstraps the ratio of mean candidate time to mean baseline time.
+ * Stores the 2.5th and 97.5th percentiles of 'resamples' ratios in
+ * *lo and *hi.
+ */
+static void bootstrap_ratio(const RunData *base, const RunData *cand, int paired,
+                            int resamples, double *lo, double *hi) {
+    double *ratios = malloc(resamples * sizeof(double));
+    for (int b = 0; b < resamples; b++) {
+        double sb = 0, sc = 0;
+        if (paired) {
+            for (int i = 0; i < base->n; i++) {
+                int k = (int)(rng_next() % (unsigned long long)base->n);
+                sb += base->total[k];
+                sc += cand->total[k];
+            }
+        } else {
+            for (int i = 0; i < base->n; i++) sb += base->total[rng_next() % (unsigned long long)base->n];
+            for (int i = 0; i < cand->n; i++) sc += cand->total[rng_next() % (unsigned long long)cand->n];
+            sb /= base->n;
+            sc /= cand->n;
+        }
+        ratios[b] = sb > 0 ? sc / sb : 1.0;
+    }
+    qsort(ratios, resamples, sizeof(double), cmp_double);
+    *lo = ratios[(int)(0.025 * (resamples - 1))];
+    *hi = ratios[(int)(0.975 * (resamples - 1))];
+    free(ratios);
+}
+
+/**
+ * Compares two run logs and prints one result line. A run is SLOWER if
+ * the whole confidence interval lies above 1 and the mean ratio exceeds
+ * 1 + threshold (FASTER likewise below). Returns the verdict, or -1 if
+ * a file could not be loaded.
+ */
+static int compare_files(const char *base_path, const char *cand_path, const char *label,
+                         double threshold, int resamples) {
+    RunData base, cand;
+    int ok = load_run(base_path, &base);
+    ok = load_run(cand_path, &cand) && ok;
+    if (!ok) {
+        free_run(&base);
+        free_run(&cand);
+        return -1;
+    }
+    if (base.n == 0 || cand.n == 0) {
+        printf("%-36s %-6s %s\n", label, base.heap, "(no queries)");
+        free_run(&base);
+        free_run(&cand);
+        return SAME;
+    }
+
+    int paired = base.n == cand.n;
+    for (int i = 0; paired && i < base.n; i++)
+        if (base.s[i] != cand.s[i] || base.t[i] != cand.t[i]) paired = 0;
+
+    double mb = mean(base.total, base.n);
+    double mc = mean(cand.total, cand.n);
+    double ratio = mb > 0 ? mc / mb : 1.0;
+    double lo, hi;
+    bootstrap_ratio(&base, &cand, paired, resamples, &lo, &hi);
+
+    Verdict v = SAME;
+    if (lo > 1.0 && ratio > 1.0 + threshold) v = SLOWER;
+    else if (hi < 1.0 && ratio < 1.0 - threshold) v = FASTER;
+    int other_host = strcmp(base.host, cand.host) != 0 || strcmp(base.build, cand.build) != 0;
+
+    printf("%-36s %-6s %7d %12.2f %12.2f %8.3f  [%.3f, %.3f] %-8s %s%s\n", label, cand.heap, cand.n,
+           1e6 * mb, 1e6 * mc, ratio, lo, hi, paired ? "paired" : "unpaired",
+           v == SLOWER ? "SLOWER" : v == FASTER ? "faster" : "~", other_host ? " *" : "");
+    if (other_host)
+        printf("    * baseline %s (%s), candidate %s (%s)\n", base.host, base.build, cand.host, cand.build);
+
+    free_run(&base);
+    free_run(&cand);
+    return v;
+}
+
+// Returns 1 if 'name' ends with ".csv".
+static int is_csv(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && strcmp(name + len - 4, ".csv") == 0;
+}
+
+/**
+ * Lists the CSV files in directory 'dir' (run logs are picked out by
+ * their header later). Returns their number and stores the names in
+ * *names; free each name and the array.
+ */
+static int list_csv_files(const char *dir, char ***names) {
+    int count = 0, cap = 16;
+    *names = malloc(cap * sizeof(char*));
+#ifdef _WIN32
+    WIN32_FIND_DATA fd;
+    char pattern[1024];
+    snprintf(pattern, sizeof(pattern), "%s\\*.csv", dir);
+    HANDLE h = FindFirstFile(pattern, &fd);
+    if (h == INVALID_HANDLE_VALUE) return 0;
+    do {
+        const char *name = fd.cFileName;
+#else
+    DIR *d = opendir(dir);
+    if (!d) return 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        const char *name = e->d_name;
+#endif
+        if (!is_csv(name)) continue;
+        if (count == cap) {
+            cap *= 2;
+            *names = realloc(*names, cap * sizeof(char*));
+        }
+        (*names)[count] = malloc(strlen(name) + 1);
+        strcpy((*names)[count++], name);
+#ifdef _WIN32
+    } while (FindNextFile(h, &fd));
+    FindClose(h);
+#else
+    }
+    closedir(d);
+#endif
+    return count;
+}
+
+static int cmp_name(const void *a, const void *b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <baseline.csv|dir> <candidate.csv|dir> [threshold_pct=5] [resamples=2000] [seed=1]\n", argv[0]);
+        printf("Compares run logs (result/*_<heap>.csv) of two benchmark runs; with directories,\n");
+        printf("files with the same name are compared. Exit status 1 if any run is SLOWER.\n");
+        return 2;
+    }
+    const char *base = argv[1];
+    const char *cand = argv[2];
+    double threshold = ((argc >= 4) ? atof(argv[3]) : 5.0) / 100.0;
+    int resamples = (argc >= 5) ? atoi(argv[4]) : 2000;
+    rng_state = (argc >= 6) ? strtoull(argv[5], NULL, 10) : 1;
+    if (resamples < 100) resamples = 100;
+
+    printf("%-36s %-6s %7s %12s %12s %8s  %-16s %-8s %s\n", "Run log", "Heap", "Queries",
+           "Base(us)", "Cand(us)", "Ratio", "95% CI", "Mode", "Verdict");
+
+    int slower = 0, compared = 0, errors = 0;
+    if (!is_directory(base) && !is_directory(cand)) {
+        const char *label = strrchr(cand, '/');
+        int v = compare_files(base, cand, label ? label + 1 : cand, threshold, resamples);
+        if (v < 0) errors++;
+        else compared++;
+        if (v == SLOWER) slower++;
+    } else if (is_directory(base) && is_directory(cand)) {
+        char **names;
+        int num = list_csv_files(base, &names);
+        qsort(names, num, sizeof(char*), cmp_name);
+        for (int i = 0; i < num; i++) {
+            char bpath[1024], cpath[1024];
+            snprintf(bpath, sizeof(bpath), "%s/%s", base, names[i]);
+            snprintf(cpath, sizeof(cpath), "%s/%s", cand, names[i]);
+            FILE *probe = fopen(cpath, "r");
+            if (!probe) {
+                printf("%-36s (missing in candidate)\n", names[i]);
+            } else if (!has_run_log_header(bpath)) {
+                fclose(probe);
+                printf("%-36s (skipped, not a run log)\n", names[i]);
+            } else {
+                fclose(probe);
+                int v = compare_files(bpath, cpath, names[i], threshold, resamples);
+                if (v < 0) errors++;
+                else compared++;
+                if (v == SLOWER) slower++;
+            }
+            free(names[i]);
+        }
+        free(names);
+    } else {
+        fprintf(stderr, "Both arguments must be run logs or both directories\n");
+        return 2;
+    }
+
+    printf("\n%d compared, %d significantly slower (threshold %.1f%%, %d resamples)%s\n",
+           compared, slower, 100.0 * threshold, resamples, errors ? ", some files unreadable" : "");
+    if (errors) return 2;
+    return slower > 0 ? 1 : 0;
+}
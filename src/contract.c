@@ -0,0 +1,394 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "contract.h"
+#include "memtrack.h"
+#include "fibheap.h"
+#include "pairingheap.h"
+
+/*
+ * ======================================================================
+ * Chain Detection
+ * ======================================================================
+ */
+
+// Lightest arc weight u -> v, or DBL_MAX if there is none.
+static double arc_weight(const Graph *g, int u, int v) {
+    double w = DBL_MAX;
+    for (Edge *e = g->adj[u]; e; e = e->next)
+        if (e->to == v && e->weight < w) w = e->weight;
+    return w;
+}
+
+/**
+ * Returns 1 if v is a chain node and stores its two neighbours in *a, *b.
+ * v must have exactly two distinct neighbours (no self-loops), and each
+ * direction of traffic through v must be complete or absent.
+ */
+static int is_chain_node(const Graph *g, int v, int *a, int *b) {
+    int nb[2], k = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (Edge *e = pass ? g->rev_adj[v] : g->adj[v]; e; e = e->next) {
+            int w = e->to;
+            if (w == v) return 0;
+            if ((k > 0 && nb[0] == w) || (k > 1 && nb[1] == w)) continue;
+            if (k == 2) return 0;
+            nb[k++] = w;
+        }
+    }
+    if (k != 2) return 0;
+
+    int in_a = 0, in_b = 0, out_a = 0, out_b = 0;
+    for (Edge *e = g->adj[v]; e; e = e->next) {
+        if (e->to == nb[0]) out_a = 1;
+        else out_b = 1;
+    }
+    for (Edge *e = g->rev_adj[v]; e; e = e->next) {
+        if (e->to == nb[0]) in_a = 1;
+        else in_b = 1;
+    }
+    if (in_a != out_b || in_b != out_a || (!in_a && !in_b)) return 0;
+
+    *a = nb[0];
+    *b = nb[1];
+    return 1;
+}
+
+// Walks from chain node 'from' over 'cur' until a kept node (returned) or 'stop' is hit.
+// Chain nodes passed are appended to 'list'.
+static int walk_chain(const char *chain, const int *na, const int *nb, int from, int cur,
+                      int stop, int *list, int *len) {
+    int prev = from;
+    while (chain[cur]) {
+        if (cur == stop) return -1; // Back at the start: a ring of chain nodes
+        list[(*len)++] = cur;
+        int next = (na[cur] == prev) ? nb[cur] : na[cur];
+        prev = cur;
+        cur = next;
+    }
+    return cur;
+}
+
+Contraction* contract_graph(const Graph *g) {
+    int n = g->num_nodes;
+    Contraction *c = xmalloc(sizeof(Contraction));
+    memset(c, 0, sizeof(Contraction));
+    c->orig_nodes = n;
+    c->orig_edges = g->num_edges;
+
+    // 1. Find the chain nodes
+    char *chain = xcalloc(n > 0 ? n : 1, 1);
+    int *na = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    int *nb = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    for (int v = 0; v < n; v++) chain[v] = (char)is_chain_node(g, v, &na[v], &nb[v]);
+
+    // 2. Group chain nodes into chains, ordered from x to y
+    c->slot = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    for (int v = 0; v < n; v++) c->slot[v] = -1;
+    int *slot_node = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    int *left = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    int cap = 1024, num_slots = 0;
+    int *start = xmalloc((cap + 1) * sizeof(int));
+    int *cx = xmalloc(cap * sizeof(int));
+    int *cy = xmalloc(cap * sizeof(int));
+    int chains = 0;
+    start[0] = 0;
+
+    for (int v = 0; v < n; v++) {
+        if (!chain[v] || c->slot[v] >= 0) continue;
+
+        int nl = 0;
+        int x = walk_chain(chain, na, nb, v, na[v], v, left, &nl);
+        if (x < 0) {
+            chain[v] = 0; // Ring: v stays as the ring's end on both sides
+            continue;
+        }
+
+        // Slots: the x side reversed, then v, then the y side
+        int base = num_slots;
+        for (int i = nl - 1; i >= 0; i--) slot_node[num_slots++] = left[i];
+        slot_node[num_slots++] = v;
+        int nr = 0;
+        int y = walk_chain(chain, na, nb, v, nb[v], v, slot_node + num_slots, &nr);
+        num_slots += nr;
+        for (int i = base; i < num_slots; i++) c->slot[slot_node[i]] = i;
+
+        if (chains == cap) {
+            cap *= 2;
+            start = xrealloc(start, (cap + 1) * sizeof(int));
+            cx = xrealloc(cx, cap * sizeof(int));
+            cy = xrealloc(cy, cap * sizeof(int));
+        }
+        cx[chains] = x;
+        cy[chains] = y;
+        start[++chains] = num_slots;
+    }
+    free(left);
+    free(na);
+    free(nb);
+
+    c->num_chains = chains;
+    c->chain_start = start;
+    c->chain_x = cx;
+    c->chain_y = cy;
+    c->slot_node = xrealloc(slot_node, (num_slots > 0 ? num_slots : 1) * sizeof(int));
+    c->slot_chain = xmalloc((num_slots > 0 ? num_slots : 1) * sizeof(int));
+    c->fw_in = xmalloc((num_slots > 0 ? num_slots : 1) * sizeof(double));
+    c->fw_out = xmalloc((num_slots > 0 ? num_slots : 1) * sizeof(double));
+    c->bw_in = xmalloc((num_slots > 0 ? num_slots : 1) * sizeof(double));
+    c->bw_out = xmalloc((num_slots > 0 ? num_slots : 1) * sizeof(double));
+    c->chain_fw = xmalloc((chains > 0 ? chains : 1) * sizeof(double));
+    c->chain_bw = xmalloc((chains > 0 ? chains : 1) * sizeof(double));
+
+    // 3. Distances along each chain, in both directions
+    for (int ch = 0; ch < chains; ch++) {
+        int lo = start[ch], hi = start[ch + 1];
+        const int *nodes = c->slot_node;
+        int x = cx[ch], y = cy[ch];
+        for (int i = lo; i < hi; i++) c->slot_chain[i] = ch;
+
+        // x -> v_1 -> ... -> v_m -> y (all arcs exist or none does)
+        double d = arc_weight(g, x, nodes[lo]);
+        for (int i = lo; i < hi; i++) {
+            c->fw_in[i] = d;
+            if (d < DBL_MAX) d += arc_weight(g, nodes[i], i + 1 < hi ? nodes[i + 1] : y);
+        }
+        c->chain_fw[ch] = d;
+        d = (d < DBL_MAX) ? 0.0 : DBL_MAX;
+        for (int i = hi - 1; i >= lo; i--) {
+            if (d < DBL_MAX) d = arc_weight(g, nodes[i], i + 1 < hi ? nodes[i + 1] : y) + d;
+            c->fw_out[i] = d;
+        }
+
+        // y -> v_m -> ... -> v_1 -> x
+        d = arc_weight(g, y, nodes[hi - 1]);
+        for (int i = hi - 1; i >= lo; i--) {
+            c->bw_in[i] = d;
+            if (d < DBL_MAX) d += arc_weight(g, nodes[i], i > lo ? nodes[i - 1] : x);
+        }
+        c->chain_bw[ch] = d;
+        d = (d < DBL_MAX) ? 0.0 : DBL_MAX;
+        for (int i = lo; i < hi; i++) {
+            if (d < DBL_MAX) d = arc_weight(g, nodes[i], i > lo ? nodes[i - 1] : x) + d;
+            c->bw_out[i] = d;
+        }
+    }
+
+    // 4. The contracted graph: kept nodes, their original arcs and one shortcut per chain direction
+    c->new_id = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    int kept = 0;
+    for (int v = 0; v < n; v++) c->new_id[v] = chain[v] ? -1 : kept++;
+    c->old_id = xmalloc((kept > 0 ? kept : 1) * sizeof(int));
+    for (int v = 0; v < n; v++) if (!chain[v]) c->old_id[c->new_id[v]] = v;
+
+    c->g = create_graph(kept);
+    for (int u = 0; u < n; u++) {
+        if (chain[u]) continue;
+        for (Edge *e = g->adj[u]; e; e = e->next)
+            if (!chain[e->to]) add_arc(c->g, c->new_id[u], c->new_id[e->to], e->weight);
+    }
+    for (int ch = 0; ch < chains; ch++) {
+        int x = c->new_id[cx[ch]], y = c->new_id[cy[ch]];
+        if (x == y) continue; // A loop back to its own end never shortens a path
+        if (c->chain_fw[ch] < DBL_MAX) add_arc(c->g, x, y, c->chain_fw[ch]);
+        if (c->chain_bw[ch] < DBL_MAX) add_arc(c->g, y, x, c->chain_bw[ch]);
+    }
+
+    // 5. Chains by end node, for arc expansion
+    c->end_start = xcalloc(kept + 1, sizeof(int));
+    c->end_chain = xmalloc((2 * chains > 0 ? 2 * chains : 1) * sizeof(int));
+    for (int ch = 0; ch < chains; ch++) {
+        c->end_start[c->new_id[cx[ch]] + 1]++;
+        c->end_start[c->new_id[cy[ch]] + 1]++;
+    }
+    for (int k = 0; k < kept; k++) c->end_start[k + 1] += c->end_start[k];
+    {
+        int *fill = xmalloc((kept > 0 ? kept : 1) * sizeof(int));
+        memcpy(fill, c->end_start, kept * sizeof(int));
+        for (int ch = 0; ch < chains; ch++) {
+            c->end_chain[fill[c->new_id[cx[ch]]]++] = ch;
+            c->end_chain[fill[c->new_id[cy[ch]]]++] = ch;
+        }
+        free(fill);
+    }
+
+    free(chain);
+    return c;
+}
+
+/*
+ * ======================================================================
+ * Queries
+ * ======================================================================
+ * A search from a chain node starts at the chain's ends, with the
+ * distances to them as initial keys; a chain node target is reached
+ * through one of its ends (or directly along the chain).
+ */
+
+// Nodes of the contracted graph a search from 's' starts at, with their initial keys.
+static int source_seeds(const Contraction *c, int s, int *node, double *key) {
+    if (c->new_id[s] >= 0) {
+        node[0] = c->new_id[s];
+        key[0] = 0.0;
+        return 1;
+    }
+    int k = c->slot[s], ch = c->slot_chain[k], ns = 0;
+    if (c->fw_out[k] < DBL_MAX) { node[ns] = c->new_id[c->chain_y[ch]]; key[ns++] = c->fw_out[k]; }
+    if (c->bw_out[k] < DBL_MAX) { node[ns] = c->new_id[c->chain_x[ch]]; key[ns++] = c->bw_out[k]; }
+    return ns;
+}
+
+// Distance from chain node s to chain node t along their common chain (DBL_MAX if none).
+static double along_chain(const Contraction *c, int s, int t) {
+    int ks = c->slot[s], kt = c->slot[t];
+    if (ks < 0 || kt < 0 || c->slot_chain[ks] != c->slot_chain[kt]) return DBL_MAX;
+    if (ks == kt) return 0.0;
+    if (kt > ks) return (c->fw_in[ks] < DBL_MAX) ? c->fw_in[kt] - c->fw_in[ks] : DBL_MAX;
+    return (c->bw_in[ks] < DBL_MAX) ? c->bw_in[kt] - c->bw_in[ks] : DBL_MAX;
+}
+
+// Distance to original node v given the distances 'd' on the contracted graph.
+static double expand_dist(const Contraction *c, const double *d, int s, int v) {
+    if (c->new_id[v] >= 0) return d[c->new_id[v]];
+    int k = c->slot[v], ch = c->slot_chain[k];
+    double best = along_chain(c, s, v);
+    double dx = d[c->new_id[c->chain_x[ch]]];
+    double dy = d[c->new_id[c->chain_y[ch]]];
+    if (dx < DBL_MAX && c->fw_in[k] < DBL_MAX && dx + c->fw_in[k] < best) best = dx + c->fw_in[k];
+    if (dy < DBL_MAX && c->bw_in[k] < DBL_MAX && dy + c->bw_in[k] < best) best = dy + c->bw_in[k];
+    return best;
+}
+
+/**
+ * Dijkstra on the contracted graph from several seeds. If 'targets' is
+ * given, stops once all of them are settled. 'd' receives the distances.
+ */
+static void search(const Contraction *c, const int *seed, const double *key, int num_seeds,
+                   const int *targets, int num_targets, int use_pair, double *d) {
+    const Graph *g = c->g;
+    int m = g->num_nodes;
+    for (int i = 0; i < m; i++) d[i] = DBL_MAX;
+
+    FibHeap *fh = use_pair ? NULL : fib_create(m);
+    PairingHeap *ph = use_pair ? pair_create(m) : NULL;
+    for (int i = 0; i < num_seeds; i++) {
+        if (key[i] >= d[seed[i]]) continue;
+        d[seed[i]] = key[i];
+        if (use_pair) pair_decrease_key(ph, seed[i], key[i]);
+        else fib_decrease_key(fh, seed[i], key[i]);
+    }
+
+    int remaining = num_targets;
+    if (num_targets == 2 && targets[0] == targets[1]) remaining = 1;
+
+    while (use_pair ? ph->root != NULL : !fib_is_empty(fh)) {
+        int u = use_pair ? pair_extract_min(ph) : fib_extract_min(fh);
+        if (u == -1) break;
+        if (num_targets > 0 && (u == targets[0] || (num_targets > 1 && u == targets[1]))) {
+            if (--remaining == 0) break;
+        }
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            double nd = d[u] + e->weight;
+            if (nd < d[e->to]) {
+                d[e->to] = nd;
+                if (use_pair) pair_decrease_key(ph, e->to, nd);
+                else fib_decrease_key(fh, e->to, nd);
+            }
+        }
+    }
+
+    if (fh) fib_free(fh);
+    if (ph) pair_free(ph);
+}
+
+int contract_sssp(const Contraction *c, int s, const char *heap_type, double *out) {
+    int use_pair;
+    if (strcmp(heap_type, "fib") == 0) use_pair = 0;
+    else if (strcmp(heap_type, "pair") == 0) use_pair = 1;
+    else return -1;
+
+    int seed[2];
+    double key[2];
+    int ns = source_seeds(c, s, seed, key);
+    double *d = xmalloc((c->g->num_nodes > 0 ? c->g->num_nodes : 1) * sizeof(double));
+    search(c, seed, key, ns, NULL, 0, use_pair, d);
+
+    for (int v = 0; v < c->orig_nodes; v++) out[v] = expand_dist(c, d, s, v);
+    out[s] = 0.0;
+    free(d);
+    return 0;
+}
+
+double contract_query(const Contraction *c, int s, int t, const char *heap_type) {
+    int use_pair;
+    if (strcmp(heap_type, "fib") == 0) use_pair = 0;
+    else if (strcmp(heap_type, "pair") == 0) use_pair = 1;
+    else return DBL_MAX;
+    if (s == t) return 0.0;
+
+    // The kept nodes t is reached through
+    int targets[2], nt = 0;
+    if (c->new_id[t] >= 0) {
+        targets[nt++] = c->new_id[t];
+    } else {
+        int ch = c->slot_chain[c->slot[t]];
+        targets[nt++] = c->new_id[c->chain_x[ch]];
+        targets[nt++] = c->new_id[c->chain_y[ch]];
+    }
+
+    int seed[2];
+    double key[2];
+    int ns = source_seeds(c, s, seed, key);
+    double *d = xmalloc((c->g->num_nodes > 0 ? c->g->num_nodes : 1) * sizeof(double));
+    search(c, seed, key, ns, targets, nt, use_pair, d);
+    double result = expand_dist(c, d, s, t);
+    free(d);
+    return result;
+}
+
+int contract_expand_arc(const Contraction *c, int u, int v, double weight, int *out, int max) {
+    if (u < 0 || v < 0 || u >= c->g->num_nodes || v >= c->g->num_nodes) return -1;
+    int ou = c->old_id[u], ov = c->old_id[v];
+
+    // Chains between u and v whose length in the u -> v direction matches
+    for (int i = c->end_start[u]; i < c->end_start[u + 1]; i++) {
+        int ch = c->end_chain[i];
+        int lo = c->chain_start[ch], hi = c->chain_start[ch + 1];
+        int forward = (c->chain_x[ch] == ou && c->chain_y[ch] == ov && c->chain_fw[ch] == weight);
+        int backward = (c->chain_y[ch] == ou && c->chain_x[ch] == ov && c->chain_bw[ch] == weight);
+        if (!forward && !backward) continue;
+
+        int len = 0;
+        for (int k = 0; k < hi - lo && len < max; k++)
+            out[len++] = c->slot_node[forward ? lo + k : hi - 1 - k];
+        return len;
+    }
+
+    // Otherwise it must be an original arc between two kept nodes
+    for (Edge *e = c->g->adj[u]; e; e = e->next)
+        if (e->to == v && e->weight == weight) return 0;
+    return -1;
+}
+
+void free_contraction(Contraction *c) {
+    if (!c) return;
+    free_graph(c->g);
+    free(c->new_id);
+    free(c->old_id);
+    free(c->chain_start);
+    free(c->chain_x);
+    free(c->chain_y);
+    free(c->chain_fw);
+    free(c->chain_bw);
+    free(c->end_start);
+    free(c->end_chain);
+    free(c->slot);
+    free(c->slot_node);
+    free(c->slot_chain);
+    free(c->fw_in);
+    free(c->fw_out);
+    free(c->bw_in);
+    free(c->bw_out);
+    free(c);
+}
@@ -0,0 +1,629 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "crp.h"
+#include "memtrack.h"
+#include "fibheap.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// One cell of the overlay on some level.
+typedef struct {
+    int num_boundary;     // Boundary nodes of the cell on its level
+    int *boundary;        // Graph node ids of those boundary nodes
+    double *clique;       // num_boundary x num_boundary distances (row = source)
+} CrpCell;
+
+struct CrpOverlay {
+    const Graph *g;
+    Partition *part;      // Owned, metric-independent
+    int num_levels;
+    CrpCell **cells;      // cells[l][c]
+
+    // Overlay vertices = nodes that are boundary on level 0.
+    // A node that is boundary on level l is boundary on every level below.
+    int num_overlay;
+    int *overlay_id;      // overlay_id[v] = compact id, or -1
+    int *overlay_node;    // overlay_node[o] = graph node id
+    signed char *top;     // top[o] = highest level on which o is boundary
+    int **bidx;           // bidx[l][o] = index in its level-l cell boundary, or -1
+
+    // Level-0 cells as node lists (for customizing the lowest level)
+    int *cell_start;      // CSR offsets per level-0 cell
+    int *cell_nodes;      // Nodes grouped by level-0 cell
+    int *local_id;        // Position of v inside its level-0 cell
+
+    // Level l >= 1: level-(l-1) boundary nodes grouped by level-l cell
+    int **member_start;   // CSR offsets per level-l cell
+    int **members;        // Overlay ids
+    int **member_pos;     // member_pos[l][o] = position inside its member list
+};
+
+struct CrpQuery {
+    const CrpOverlay *o;
+    double *dist;         // Tentative distances, DBL_MAX outside the last search
+    int *touched;         // Nodes whose dist must be reset
+    int num_touched;
+    FibHeap *H;           // Reused between queries (cleared, not recreated)
+};
+
+/*
+ * ======================================================================
+ * Metric-independent Overlay Construction
+ * ======================================================================
+ */
+
+CrpOverlay* crp_build(const Graph *g, int num_levels, const int *cell_sizes) {
+    int n = g->num_nodes;
+    CrpOverlay *o = xmalloc(sizeof(CrpOverlay));
+    o->g = g;
+    o->num_levels = num_levels;
+    o->part = partition_graph(g, num_levels, cell_sizes);
+    int **cell = o->part->cell;
+
+    // 1. Highest level on which each node is incident to a cut arc.
+    //    Partitions are nested, so an arc cut on level l is cut below it too.
+    signed char *top_node = xmalloc(n);
+    memset(top_node, -1, n);
+    for (int u = 0; u < n; u++) {
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            int lvl = -1;
+            for (int l = num_levels - 1; l >= 0; l--) {
+                if (cell[l][u] != cell[l][v]) { lvl = l; break; }
+            }
+            if (lvl > top_node[u]) top_node[u] = (signed char)lvl;
+            if (lvl > top_node[v]) top_node[v] = (signed char)lvl;
+        }
+    }
+
+    // 2. Compact ids for overlay vertices
+    o->overlay_id = xmalloc(n * sizeof(int));
+    o->num_overlay = 0;
+    for (int v = 0; v < n; v++)
+        o->overlay_id[v] = (top_node[v] >= 0) ? o->num_overlay++ : -1;
+
+    int m = o->num_overlay;
+    o->overlay_node = xmalloc((m > 0 ? m : 1) * sizeof(int));
+    o->top = xmalloc(m > 0 ? m : 1);
+    for (int v = 0; v < n; v++) {
+        int id = o->overlay_id[v];
+        if (id < 0) continue;
+        o->overlay_node[id] = v;
+        o->top[id] = top_node[v];
+    }
+    free(top_node);
+
+    // 3. Boundary lists of every cell on every level
+    o->cells = xmalloc(num_levels * sizeof(CrpCell*));
+    o->bidx = xmalloc(num_levels * sizeof(int*));
+    for (int l = 0; l < num_levels; l++) {
+        int k = o->part->num_cells[l];
+        CrpCell *cs = xmalloc(k * sizeof(CrpCell));
+        for (int c = 0; c < k; c++) {
+            cs[c].num_boundary = 0;
+            cs[c].clique = NULL;
+        }
+        for (int id = 0; id < m; id++)
+            if (o->top[id] >= l) cs[cell[l][o->overlay_node[id]]].num_boundary++;
+        for (int c = 0; c < k; c++) {
+            cs[c].boundary = xmalloc((cs[c].num_boundary > 0 ? cs[c].num_boundary : 1) * sizeof(int));
+            cs[c].num_boundary = 0;
+        }
+
+        o->bidx[l] = xmalloc((m > 0 ? m : 1) * sizeof(int));
+        for (int id = 0; id < m; id++) {
+            o->bidx[l][id] = -1;
+            if (o->top[id] < l) continue;
+            int v = o->overlay_node[id];
+            CrpCell *c = &cs[cell[l][v]];
+            o->bidx[l][id] = c->num_boundary;
+            c->boundary[c->num_boundary++] = v;
+        }
+        for (int c = 0; c < k; c++) {
+            long nb = cs[c].num_boundary;
+            cs[c].clique = xmalloc((nb * nb > 0 ? nb * nb : 1) * sizeof(double));
+        }
+        o->cells[l] = cs;
+    }
+
+    // 4. Level-0 cells as node lists
+    int k0 = o->part->num_cells[0];
+    o->cell_start = xmalloc((k0 + 1) * sizeof(int));
+    o->cell_nodes = xmalloc(n * sizeof(int));
+    o->local_id = xmalloc(n * sizeof(int));
+    memset(o->cell_start, 0, (k0 + 1) * sizeof(int));
+    for (int v = 0; v < n; v++) o->cell_start[cell[0][v] + 1]++;
+    for (int c = 0; c < k0; c++) o->cell_start[c + 1] += o->cell_start[c];
+    {
+        int *fill = xmalloc(k0 * sizeof(int));
+        memcpy(fill, o->cell_start, k0 * sizeof(int));
+        for (int v = 0; v < n; v++) {
+            int c = cell[0][v];
+            o->local_id[v] = fill[c] - o->cell_start[c];
+            o->cell_nodes[fill[c]++] = v;
+        }
+        free(fill);
+    }
+
+    // 5. Level l >= 1: group the level-(l-1) boundary nodes by level-l cell
+    o->member_start = xmalloc(num_levels * sizeof(int*));
+    o->members = xmalloc(num_levels * sizeof(int*));
+    o->member_pos = xmalloc(num_levels * sizeof(int*));
+    o->member_start[0] = o->members[0] = o->member_pos[0] = NULL;
+    for (int l = 1; l < num_levels; l++) {
+        int k = o->part->num_cells[l];
+        int *start = xmalloc((k + 1) * sizeof(int));
+        memset(start, 0, (k + 1) * sizeof(int));
+        for (int id = 0; id < m; id++)
+            if (o->top[id] >= l - 1) start[cell[l][o->overlay_node[id]] + 1]++;
+        for (int c = 0; c < k; c++) start[c + 1] += start[c];
+
+        int *mem = xmalloc((start[k] > 0 ? start[k] : 1) * sizeof(int));
+        int *pos = xmalloc((m > 0 ? m : 1) * sizeof(int));
+        int *fill = xmalloc((k > 0 ? k : 1) * sizeof(int));
+        memcpy(fill, start, k * sizeof(int));
+        for (int id = 0; id < m; id++) {
+            pos[id] = -1;
+            if (o->top[id] < l - 1) continue;
+            int c = cell[l][o->overlay_node[id]];
+            pos[id] = fill[c] - start[c];
+            mem[fill[c]++] = id;
+        }
+        free(fill);
+        o->member_start[l] = start;
+        o->members[l] = mem;
+        o->member_pos[l] = pos;
+    }
+
+    return o;
+}
+
+/*
+ * ======================================================================
+ * Customization
+ * ======================================================================
+ * Each cell is independent of the other cells on its level, so the
+ * cells of one level are customized in parallel. Levels are processed
+ * bottom-up because level l is built from the cliques of level l-1.
+ */
+
+// Runs a local Dijkstra from 'src' over the level-0 cell 'c' (original arcs only).
+static void customize_local0(const CrpOverlay *o, int c, int src, double *dist, FibHeap *H) {
+    const Graph *g = o->g;
+    const int *cell0 = o->part->cell[0];
+    int base = o->cell_start[c];
+    int size = o->cell_start[c + 1] - base;
+
+    for (int i = 0; i < size; i++) dist[i] = DBL_MAX;
+    dist[src] = 0.0;
+    fib_insert(H, 0.0, src);
+
+    while (!fib_is_empty(H)) {
+        int lu = fib_extract_min(H);
+        int u = o->cell_nodes[base + lu];
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            if (cell0[e->to] != c) continue; // Stay inside the cell
+            int lv = o->local_id[e->to];
+            double nd = dist[lu] + e->weight;
+            if (nd < dist[lv]) {
+                dist[lv] = nd;
+                fib_decrease_key(H, lv, nd);
+            }
+        }
+    }
+}
+
+static void customize_cell0(CrpOverlay *o, int c) {
+    CrpCell *cc = &o->cells[0][c];
+    int nb = cc->num_boundary;
+    if (nb == 0) return;
+
+    int size = o->cell_start[c + 1] - o->cell_start[c];
+    double *dist = xmalloc(size * sizeof(double));
+    FibHeap *H = fib_create(size);
+
+    for (int i = 0; i < nb; i++) {
+        customize_local0(o, c, o->local_id[cc->boundary[i]], dist, H);
+        for (int j = 0; j < nb; j++)
+            cc->clique[(long)i * nb + j] = dist[o->local_id[cc->boundary[j]]];
+    }
+
+    fib_free(H);
+    free(dist);
+}
+
+/**
+ * Customizes a cell on level l >= 1. The local graph consists of the
+ * level-(l-1) boundary nodes inside the cell, connected by the cliques
+ * of their subcells and by the original arcs cut on level l-1.
+ */
+static void customize_cell(CrpOverlay *o, int l, int c) {
+    CrpCell *cc = &o->cells[l][c];
+    int nb = cc->num_boundary;
+    if (nb == 0) return;
+
+    const Graph *g = o->g;
+    const int *below = o->part->cell[l - 1];
+    const int *here = o->part->cell[l];
+    const int *start = o->member_start[l];
+    const int *mem = o->members[l] + start[c];
+    const int *pos = o->member_pos[l];
+    int size = start[c + 1] - start[c];
+
+    double *dist = xmalloc(size * sizeof(double));
+    FibHeap *H = fib_create(size);
+
+    for (int i = 0; i < nb; i++) {
+        int src = pos[o->overlay_id[cc->boundary[i]]];
+        for (int j = 0; j < size; j++) dist[j] = DBL_MAX;
+        dist[src] = 0.0;
+        fib_insert(H, 0.0, src);
+
+        while (!fib_is_empty(H)) {
+            int lu = fib_extract_min(H);
+            int id = mem[lu];
+            int u = o->overlay_node[id];
+            double du = dist[lu];
+
+            // Shortcuts through the level-(l-1) subcell of u
+            const CrpCell *sub = &o->cells[l - 1][below[u]];
+            const double *row = sub->clique + (long)o->bidx[l - 1][id] * sub->num_boundary;
+            for (int j = 0; j < sub->num_boundary; j++) {
+                if (row[j] == DBL_MAX) continue;
+                int lv = pos[o->overlay_id[sub->boundary[j]]];
+                double nd = du + row[j];
+                if (nd < dist[lv]) {
+                    dist[lv] = nd;
+                    fib_decrease_key(H, lv, nd);
+                }
+            }
+
+            // Original arcs between subcells of this cell
+            for (Edge *e = g->adj[u]; e; e = e->next) {
+                int v = e->to;
+                if (below[v] == below[u] || here[v] != c) continue;
+                int lv = pos[o->overlay_id[v]];
+                double nd = du + e->weight;
+                if (nd < dist[lv]) {
+                    dist[lv] = nd;
+                    fib_decrease_key(H, lv, nd);
+                }
+            }
+        }
+
+        for (int j = 0; j < nb; j++)
+            cc->clique[(long)i * nb + j] = dist[pos[o->overlay_id[cc->boundary[j]]]];
+    }
+
+    fib_free(H);
+    free(dist);
+}
+
+void crp_customize(CrpOverlay *o) {
+    for (int l = 0; l < o->num_levels; l++) {
+        int k = o->part->num_cells[l];
+        #pragma omp parallel for schedule(dynamic, 4)
+        for (int c = 0; c < k; c++) {
+            if (l == 0) customize_cell0(o, c);
+            else customize_cell(o, l, c);
+        }
+    }
+}
+
+/*
+ * ======================================================================
+ * Queries
+ * ======================================================================
+ */
+
+CrpQuery* crp_query_create(const CrpOverlay *o) {
+    int n = o->g->num_nodes;
+    CrpQuery *q = xmalloc(sizeof(CrpQuery));
+    q->o = o;
+    q->dist = xmalloc(n * sizeof(double));
+    q->touched = xmalloc(n * sizeof(int));
+    q->num_touched = 0;
+    for (int i = 0; i < n; i++) q->dist[i] = DBL_MAX;
+    q->H = fib_create(n);
+    return q;
+}
+
+// Relaxes node v to distance 'nd' inside a query.
+static void query_relax(CrpQuery *q, int v, double nd) {
+    if (nd >= q->dist[v]) return;
+    if (q->dist[v] == DBL_MAX) q->touched[q->num_touched++] = v;
+    q->dist[v] = nd;
+    fib_decrease_key(q->H, v, nd);
+}
+
+/**
+ * Search level of node v for the pair (s, t): 0 if v shares its
+ * level-0 cell with s or t, otherwise 1 + the highest level on which
+ * v's cell contains neither s nor t.
+ */
+static int search_level(const CrpOverlay *o, int s, int t, int v) {
+    for (int l = o->num_levels - 1; l >= 0; l--) {
+        const int *cell = o->part->cell[l];
+        if (cell[v] != cell[s] && cell[v] != cell[t]) return l + 1;
+    }
+    return 0;
+}
+
+/**
+ * Scans node u of a search for the pair (s, t). A forward search follows
+ * arcs and clique rows; a backward search (toward t) follows reverse
+ * arcs and clique columns.
+ */
+static void scan_node(CrpQuery *q, int u, int s, int t, int backward) {
+    const CrpOverlay *o = q->o;
+    const Graph *g = o->g;
+    Edge *arcs = backward ? g->rev_adj[u] : g->adj[u];
+    double du = q->dist[u];
+    int k = search_level(o, s, t, u);
+    int id = o->overlay_id[u];
+
+    if (k == 0 || id < 0 || o->top[id] < k - 1) {
+        // Inside the cells of s or t: scan the original arcs
+        for (Edge *e = arcs; e; e = e->next)
+            query_relax(q, e->to, du + e->weight);
+        return;
+    }
+
+    // Foreign cell on level l: jump over it with the clique,
+    // then leave it through arcs cut on level l.
+    int l = k - 1;
+    const int *cell = o->part->cell[l];
+    const CrpCell *c = &o->cells[l][cell[u]];
+    int nb = c->num_boundary;
+    long i = o->bidx[l][id];
+    for (int j = 0; j < nb; j++) {
+        double w = backward ? c->clique[(long)j * nb + i] : c->clique[i * nb + j];
+        if (w != DBL_MAX) query_relax(q, c->boundary[j], du + w);
+    }
+    for (Edge *e = arcs; e; e = e->next) {
+        if (cell[e->to] != cell[u]) query_relax(q, e->to, du + e->weight);
+    }
+}
+
+// Clears the state left in the workspace by the previous search.
+static void query_reset(CrpQuery *q) {
+    for (int i = 0; i < q->num_touched; i++) q->dist[q->touched[i]] = DBL_MAX;
+    q->num_touched = 0;
+    fib_clear(q->H);
+}
+
+double crp_query(CrpQuery *q, int s, int t, int *out_settled) {
+    query_reset(q);
+
+    int settled = 0;
+    query_relax(q, s, 0.0);
+
+    while (!fib_is_empty(q->H)) {
+        int u = fib_extract_min(q->H);
+        settled++;
+        if (u == t) break;
+        scan_node(q, u, s, t, 0);
+    }
+
+    if (out_settled) *out_settled = settled;
+    return q->dist[t];
+}
+
+void crp_query_free(CrpQuery *q) {
+    if (!q) return;
+    fib_free(q->H);
+    free(q->dist);
+    free(q->touched);
+    free(q);
+}
+
+/*
+ * ======================================================================
+ * Many-to-many Distance Tables
+ * ======================================================================
+ * Bucket-based table computation on the overlay:
+ *  1. One backward search per target t, with levels relative to t only.
+ *     Every node v it settles gets the entry (t, dist(v, t)) in its bucket.
+ *  2. One forward search per source s, with levels relative to s only.
+ *     Every settled node v combines dist(s, v) with the entries of its
+ *     bucket.
+ * On a shortest s-t path, the node where it first leaves the cell of s
+ * on the lowest level that separates s and t lies in both search graphs
+ * with exact labels, so the minimum over all buckets is dist(s, t).
+ */
+
+// One bucket entry produced by a backward search.
+typedef struct {
+    int node;             // Node whose bucket holds the entry
+    int target;           // Column index in the table
+    double dist;          // dist(node, target)
+} BucketEntry;
+
+// Growable list of bucket entries (one per thread).
+typedef struct {
+    BucketEntry *a;
+    long size;
+    long cap;
+} EntryVec;
+
+static void entry_push(EntryVec *v, int node, int target, double dist) {
+    if (v->size == v->cap) {
+        v->cap = v->cap ? v->cap * 2 : 1024;
+        v->a = xrealloc(v->a, v->cap * sizeof(BucketEntry));
+    }
+    v->a[v->size].node = node;
+    v->a[v->size].target = target;
+    v->a[v->size].dist = dist;
+    v->size++;
+}
+
+/**
+ * Runs an unbounded search from 'root' with levels relative to 'root'
+ * only. Writes the settled nodes to 'out' and returns their number;
+ * their distances are left in q->dist.
+ */
+static int one_sided_search(CrpQuery *q, int root, int backward, int *out) {
+    query_reset(q);
+    int settled = 0;
+    query_relax(q, root, 0.0);
+    while (!fib_is_empty(q->H)) {
+        int u = fib_extract_min(q->H);
+        out[settled++] = u;
+        scan_node(q, u, root, root, backward);
+    }
+    return settled;
+}
+
+long crp_distance_table(const CrpOverlay *o, const int *sources, int num_sources,
+                        const int *targets, int num_targets, double *table) {
+    int n = o->g->num_nodes;
+#ifdef _OPENMP
+    int nt = omp_get_max_threads();
+#else
+    int nt = 1;
+#endif
+    EntryVec *vecs = xmalloc(nt * sizeof(EntryVec));
+    memset(vecs, 0, nt * sizeof(EntryVec));
+    long settled_total = 0;
+
+    // 1. Backward searches fill per-thread entry lists
+    #pragma omp parallel num_threads(nt) reduction(+:settled_total)
+    {
+#ifdef _OPENMP
+        EntryVec *my = &vecs[omp_get_thread_num()];
+#else
+        EntryVec *my = &vecs[0];
+#endif
+        CrpQuery *q = crp_query_create(o);
+        int *order = xmalloc(n * sizeof(int));
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int j = 0; j < num_targets; j++) {
+            int t = targets[j];
+            if (t < 0 || t >= n) continue;
+            int k = one_sided_search(q, t, 1, order);
+            settled_total += k;
+            for (int i = 0; i < k; i++) entry_push(my, order[i], j, q->dist[order[i]]);
+        }
+
+        free(order);
+        crp_query_free(q);
+    }
+
+    // 2. Group the entries into per-node buckets (CSR)
+    long *bstart = xmalloc((n + 1) * sizeof(long));
+    memset(bstart, 0, (n + 1) * sizeof(long));
+    long total = 0;
+    for (int w = 0; w < nt; w++) {
+        for (long i = 0; i < vecs[w].size; i++) bstart[vecs[w].a[i].node + 1]++;
+        total += vecs[w].size;
+    }
+    for (int v = 0; v < n; v++) bstart[v + 1] += bstart[v];
+
+    int *btarget = xmalloc((total > 0 ? total : 1) * sizeof(int));
+    double *bdist = xmalloc((total > 0 ? total : 1) * sizeof(double));
+    {
+        long *fill = xmalloc(n * sizeof(long));
+        memcpy(fill, bstart, n * sizeof(long));
+        for (int w = 0; w < nt; w++) {
+            for (long i = 0; i < vecs[w].size; i++) {
+                const BucketEntry *be = &vecs[w].a[i];
+                long pos = fill[be->node]++;
+                btarget[pos] = be->target;
+                bdist[pos] = be->dist;
+            }
+            free(vecs[w].a);
+        }
+        free(fill);
+    }
+    free(vecs);
+
+    // 3. Forward searches scan the buckets; rows are independent
+    #pragma omp parallel num_threads(nt) reduction(+:settled_total)
+    {
+        CrpQuery *q = crp_query_create(o);
+        int *order = xmalloc(n * sizeof(int));
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < num_sources; i++) {
+            double *row = table + (long)i * num_targets;
+            for (int j = 0; j < num_targets; j++) row[j] = DBL_MAX;
+            int s = sources[i];
+            if (s < 0 || s >= n) continue;
+
+            int k = one_sided_search(q, s, 0, order);
+            settled_total += k;
+            for (int x = 0; x < k; x++) {
+                int v = order[x];
+                double dv = q->dist[v];
+                for (long b = bstart[v]; b < bstart[v + 1]; b++) {
+                    double d = dv + bdist[b];
+                    if (d < row[btarget[b]]) row[btarget[b]] = d;
+                }
+            }
+        }
+
+        free(order);
+        crp_query_free(q);
+    }
+
+    free(btarget);
+    free(bdist);
+    free(bstart);
+    return settled_total;
+}
+
+/*
+ * ======================================================================
+ * Accessors and Cleanup
+ * ======================================================================
+ */
+
+const Partition* crp_partition(const CrpOverlay *o) {
+    return o->part;
+}
+
+int crp_num_overlay_nodes(const CrpOverlay *o) {
+    return o->num_overlay;
+}
+
+long crp_num_clique_entries(const CrpOverlay *o, int level) {
+    long total = 0;
+    for (int c = 0; c < o->part->num_cells[level]; c++) {
+        long nb = o->cells[level][c].num_boundary;
+        total += nb * nb;
+    }
+    return total;
+}
+
+void crp_free(CrpOverlay *o) {
+    if (!o) return;
+    for (int l = 0; l < o->num_levels; l++) {
+        for (int c = 0; c < o->part->num_cells[l]; c++) {
+            free(o->cells[l][c].boundary);
+            free(o->cells[l][c].clique);
+        }
+        free(o->cells[l]);
+        free(o->bidx[l]);
+        free(o->member_start[l]);
+        free(o->members[l]);
+        free(o->member_pos[l]);
+    }
+    free(o->cells);
+    free(o->bidx);
+    free(o->member_start);
+    free(o->members);
+    free(o->member_pos);
+    free(o->overlay_id);
+    free(o->overlay_node);
+    free(o->top);
+    free(o->cell_start);
+    free(o->cell_nodes);
+    free(o->local_id);
+    free_partition(o->part);
+    free(o);
+}
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "deltastep.h"
+#include "memtrack.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// A growable array of node ids.
+typedef struct {
+    int *a;
+    int size;
+    int cap;
+} IntVec;
+
+// The bucket buffers owned by one thread: b[i] holds nodes for bucket i.
+typedef struct {
+    IntVec *b;
+    long nb;              // Number of allocated bucket slots
+    IntVec settled;       // Nodes this thread added to the current bucket's set R
+} ThreadBuckets;
+
+static void vec_push(IntVec *v, int x) {
+    if (v->size == v->cap) {
+        v->cap = v->cap ? v->cap * 2 : 16;
+        v->a = xrealloc(v->a, v->cap * sizeof(int));
+    }
+    v->a[v->size++] = x;
+}
+
+// Appends 'v' to bucket 'idx' of a thread's buffers, growing the slot array.
+static void bucket_push(ThreadBuckets *tb, long idx, int v) {
+    if (idx >= tb->nb) {
+        long nb = tb->nb ? tb->nb : 64;
+        while (nb <= idx) nb *= 2;
+        tb->b = xrealloc(tb->b, nb * sizeof(IntVec));
+        memset(tb->b + tb->nb, 0, (nb - tb->nb) * sizeof(IntVec));
+        tb->nb = nb;
+    }
+    vec_push(&tb->b[idx], v);
+}
+
+/**
+ * Atomically lowers dist[v] to 'nd'. On success, the relaxing thread
+ * files v into its own bucket buffer.
+ */
+static void relax(_Atomic double *dist, int v, double nd, double delta, ThreadBuckets *tb) {
+    double old = atomic_load_explicit(&dist[v], memory_order_relaxed);
+    while (nd < old) {
+        if (atomic_compare_exchange_weak_explicit(&dist[v], &old, nd,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            bucket_push(tb, (long)(nd / delta), v);
+            return;
+        }
+    }
+}
+
+double* dijkstra_delta(const Graph *g, int s, double delta, int num_threads) {
+    int n = g->num_nodes;
+
+    // Default bucket width: the average arc weight
+    if (delta <= 0) {
+        double sum = 0;
+        long m = 0;
+        for (int u = 0; u < n; u++)
+            for (Edge *e = g->adj[u]; e; e = e->next, m++) sum += e->weight;
+        delta = (m > 0 && sum > 0) ? sum / m : 1.0;
+    }
+
+#ifdef _OPENMP
+    int nt = (num_threads > 0) ? num_threads : omp_get_max_threads();
+#else
+    int nt = 1;
+    (void)num_threads;
+#endif
+
+    _Atomic double *dist = xmalloc(n * sizeof(_Atomic double));
+    atomic_char *in_r = xmalloc(n * sizeof(atomic_char));
+    #pragma omp parallel for num_threads(nt)
+    for (int i = 0; i < n; i++) {
+        atomic_init(&dist[i], DBL_MAX);
+        atomic_init(&in_r[i], 0);
+    }
+
+    ThreadBuckets *tb = xmalloc(nt * sizeof(ThreadBuckets));
+    memset(tb, 0, nt * sizeof(ThreadBuckets));
+    long *mins = xmalloc(nt * sizeof(long));
+    long *offs = xmalloc((nt + 1) * sizeof(long));
+
+    atomic_store(&dist[s], 0.0);
+    bucket_push(&tb[0], 0, s);
+
+    // Shared state, only written inside 'omp single' blocks
+    int *frontier = NULL;
+    long frontier_cap = 0, frontier_size = 0;
+    long cur = 0;
+    int done = 0;
+
+    #pragma omp parallel num_threads(nt)
+    {
+#ifdef _OPENMP
+        int tid = omp_get_thread_num();
+#else
+        int tid = 0;
+#endif
+        ThreadBuckets *my = &tb[tid];
+
+        while (1) {
+            // 1. The next bucket is the lowest non-empty one over all threads
+            long my_min = LONG_MAX;
+            for (long i = cur; i < my->nb; i++) {
+                if (my->b[i].size > 0) { my_min = i; break; }
+            }
+            mins[tid] = my_min;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                long m = LONG_MAX;
+                for (int t = 0; t < nt; t++) if (mins[t] < m) m = mins[t];
+                if (m == LONG_MAX) done = 1;
+                else cur = m;
+            }
+            if (done) break;
+            long i = cur;
+
+            // 2. Light phases: empty bucket i until no light relaxation refills it
+            while (1) {
+                int mine = (i < my->nb) ? my->b[i].size : 0;
+                offs[tid + 1] = mine;
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    offs[0] = 0;
+                    for (int t = 0; t < nt; t++) offs[t + 1] += offs[t];
+                    frontier_size = offs[nt];
+                    if (frontier_size > frontier_cap) {
+                        frontier_cap = frontier_size * 2;
+                        free(frontier);
+                        frontier = xmalloc(frontier_cap * sizeof(int));
+                    }
+                }
+                if (frontier_size == 0) break;
+
+                if (mine > 0) {
+                    memcpy(frontier + offs[tid], my->b[i].a, mine * sizeof(int));
+                    my->b[i].size = 0;
+                }
+                #pragma omp barrier
+
+                #pragma omp for schedule(dynamic, 64)
+                for (long k = 0; k < frontier_size; k++) {
+                    int u = frontier[k];
+                    double du = atomic_load_explicit(&dist[u], memory_order_relaxed);
+                    if ((long)(du / delta) != i) continue; // Stale entry
+
+                    if (!atomic_exchange_explicit(&in_r[u], 1, memory_order_relaxed))
+                        vec_push(&my->settled, u);
+
+                    for (Edge *e = g->adj[u]; e; e = e->next) {
+                        if (e->weight <= delta) relax(dist, e->to, du + e->weight, delta, my);
+                    }
+                }
+            }
+
+            // 3. Heavy phase: every node settled in bucket i relaxes its heavy arcs once
+            for (int k = 0; k < my->settled.size; k++) {
+                int u = my->settled.a[k];
+                double du = atomic_load_explicit(&dist[u], memory_order_relaxed);
+                atomic_store_explicit(&in_r[u], 0, memory_order_relaxed);
+                for (Edge *e = g->adj[u]; e; e = e->next) {
+                    if (e->weight > delta) relax(dist, e->to, du + e->weight, delta, my);
+                }
+            }
+            my->settled.size = 0;
+            #pragma omp barrier
+        }
+    }
+
+    // Copy out into a plain array so callers treat it like dijkstra_fibheap's result
+    double *out = xmalloc(n * sizeof(double));
+    #pragma omp parallel for num_threads(nt)
+    for (int v = 0; v < n; v++) out[v] = atomic_load_explicit(&dist[v], memory_order_relaxed);
+
+    for (int t = 0; t < nt; t++) {
+        for (long b = 0; b < tb[t].nb; b++) free(tb[t].b[b].a);
+        free(tb[t].b);
+        free(tb[t].settled.a);
+    }
+    free(tb);
+    free(mins);
+    free(offs);
+    free(frontier);
+    free(in_r);
+    free(dist);
+    return out;
+}
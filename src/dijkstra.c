@@ -1,8 +1,10 @@
 #include <float.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdatomic.h>
 #include "dijkstra.h"
 #include "graph.h"
+#include "timer.h"
 
 /*
  * ======================================================================
@@ -132,7 +134,7 @@ double* dijkstra_pairingheap(const Graph *g, int s) {
  * Bidirectional Dijkstra (Not part of the main benchmark)
  * ======================================================================
  * This is an alternative implementation for single-pair queries,
- * using two standard binary heaps. It is not called by main.c.
+ * using two standard binary heaps. main.c only uses it in "bidi" mode.
  */
 
 double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visited, int *out_backward_visited) {
@@ -197,6 +199,8 @@ double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visi
                         if (nd < distF[v]) {
                             distF[v] = nd;
                             heap_push(hf, nd, v);
+                            // v may already be reached by the backward search
+                            if (distB[v] < DBL_MAX && nd + distB[v] < best) best = nd + distB[v];
                         }
                     }
                 }
@@ -224,6 +228,7 @@ double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visi
                         if (nd < distB[v]) {
                             distB[v] = nd;
                             heap_push(hb, nd, v);
+                            if (distF[v] < DBL_MAX && nd + distF[v] < best) best = nd + distF[v];
                         }
                     }
                 }
@@ -237,17 +242,9 @@ double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visi
         
         // If the sum of the two smallest unvisited nodes is >= the best
         // path found so far, we can stop.
+        // 'best' is updated during relaxation, whenever an arc reaches a
+        // node the other search has already labeled.
         if (topF + topB >= best) break;
-
-        // --- Update best path ---
-        // This is inefficient (O(n)), but simple.
-        // A better way is to check only when a node is visited by both searches.
-        for (int i = 0; i < n; i++) {
-            if (distF[i] < DBL_MAX && distB[i] < DBL_MAX) {
-                double cand = distF[i] + distB[i];
-                if (cand < best) best = cand;
-            }
-        }
     }
 
     // Output stats if requested
@@ -265,6 +262,128 @@ double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visi
     return best;
 }
 
+/*
+ * ======================================================================
+ * Concurrent Bidirectional Dijkstra
+ * ======================================================================
+ * The forward search (g->adj) and the backward search (g->rev_adj) run
+ * on two threads. Each thread is the only writer of its own distance
+ * array; the other thread only reads it to detect meeting nodes. Both
+ * accesses are sequentially consistent, so when the two searches label
+ * the same node concurrently at least one of them sees the other's
+ * label and records the candidate path.
+ */
+
+// State shared by the two search threads.
+typedef struct {
+    const Graph *g;
+    int s, t;
+    _Atomic double *dist[2];      // [0] forward from s, [1] backward from t
+    _Atomic double top[2];        // Last key settled by each side (monotone)
+    _Atomic double best;          // Shortest s-t path length found so far
+    atomic_int stop;              // Set by the side that detects termination
+    int expanded[2];
+} BiShared;
+
+// Lowers sh->best to 'cand' (lock-free).
+static void bi_offer(BiShared *sh, double cand) {
+    double cur = atomic_load(&sh->best);
+    while (cand < cur && !atomic_compare_exchange_weak(&sh->best, &cur, cand))
+        ;
+}
+
+// Runs one side of the concurrent search ('side' 0 = forward, 1 = backward).
+static void bi_side(BiShared *sh, int side) {
+    const Graph *g = sh->g;
+    _Atomic double *mine = sh->dist[side];
+    _Atomic double *other = sh->dist[1 - side];
+    Edge **arcs = side ? g->rev_adj : g->adj;
+    int root = side ? sh->t : sh->s;
+    int expanded = 0;
+
+    MinHeap *h = heap_create(1024);
+    atomic_store(&mine[root], 0.0);
+    if (atomic_load(&other[root]) < DBL_MAX) bi_offer(sh, atomic_load(&other[root]));
+    heap_push(h, 0.0, root);
+
+    while (!atomic_load_explicit(&sh->stop, memory_order_relaxed)) {
+        double key; int u;
+        if (!heap_pop(h, &key, &u)) {
+            // Search space exhausted: every reachable node is labeled
+            atomic_store(&sh->top[side], DBL_MAX);
+            atomic_store(&sh->stop, 1);
+            break;
+        }
+        double du = atomic_load_explicit(&mine[u], memory_order_relaxed);
+        if (key > du) continue; // Stale entry
+
+        // Keys settle in increasing order, so the other side's published
+        // key is a lower bound for everything it has not settled yet
+        atomic_store(&sh->top[side], key);
+        if (key + atomic_load(&sh->top[1 - side]) >= atomic_load(&sh->best)) {
+            atomic_store(&sh->stop, 1);
+            break;
+        }
+
+        expanded++;
+        for (Edge *e = arcs[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = du + e->weight;
+            if (nd < atomic_load_explicit(&mine[v], memory_order_relaxed)) {
+                atomic_store(&mine[v], nd);
+                heap_push(h, nd, v);
+                double dv = atomic_load(&other[v]);
+                if (dv < DBL_MAX) bi_offer(sh, nd + dv);
+            }
+        }
+    }
+
+    sh->expanded[side] = expanded;
+    heap_free(h);
+}
+
+double dijkstra_bi_concurrent(const Graph *g, int s, int t, int *out_forward_visited, int *out_backward_visited) {
+    int n = g->num_nodes;
+    BiShared sh;
+    sh.g = g;
+    sh.s = s;
+    sh.t = t;
+    for (int side = 0; side < 2; side++) {
+        sh.dist[side] = malloc(n * sizeof(_Atomic double));
+        atomic_init(&sh.top[side], 0.0);
+        sh.expanded[side] = 0;
+    }
+    atomic_init(&sh.best, s == t ? 0.0 : DBL_MAX);
+    atomic_init(&sh.stop, s == t);
+
+    for (int i = 0; i < n; i++) {
+        atomic_init(&sh.dist[0][i], DBL_MAX);
+        atomic_init(&sh.dist[1][i], DBL_MAX);
+    }
+    // Publish both root labels up front. Without OpenMP the sections run
+    // one after the other; the forward side then sees t labeled 0 and
+    // top[1] = 0, so it stops once its key reaches d(s, t) (a plain p2p
+    // search) instead of settling the whole graph, and the backward
+    // side finds the stop flag set.
+    atomic_store(&sh.dist[0][s], 0.0);
+    atomic_store(&sh.dist[1][t], 0.0);
+
+    #pragma omp parallel sections num_threads(2)
+    {
+        #pragma omp section
+        bi_side(&sh, 0);
+        #pragma omp section
+        bi_side(&sh, 1);
+    }
+
+    if (out_forward_visited) *out_forward_visited = sh.expanded[0];
+    if (out_backward_visited) *out_backward_visited = sh.expanded[1];
+    double best = atomic_load(&sh.best);
+    free(sh.dist[0]);
+    free(sh.dist[1]);
+    return best;
+}
+
 /*
  * ======================================================================
  * Core Unidirectional Dijkstra Implementations
@@ -277,10 +396,19 @@ double dijkstra_bi_one_query(const Graph *g, int s, int t, int *out_forward_visi
  * The 'dist' array is pre-allocated by the wrapper.
  */
 void dijkstra_fib(const Graph *g, int s, double *dist) {
+    FibHeap *H = fib_create(g->num_nodes);
+    dijkstra_fib_ws(g, s, dist, H);
+    fib_free(H);
+}
+
+/**
+ * The Fibonacci heap search loop. The heap is supplied by the caller
+ * and drained completely, so it can be reused for the next source.
+ */
+void dijkstra_fib_ws(const Graph *g, int s, double *dist, FibHeap *H) {
     // Initialize all distances to infinity
     for (int i = 0; i < g->num_nodes; i++) dist[i] = DBL_MAX;
 
-    FibHeap *H = fib_create(g->num_nodes);
     dist[s] = 0.0;
     fib_insert(H, 0.0, s);
 
@@ -302,7 +430,6 @@ void dijkstra_fib(const Graph *g, int s, double *dist) {
             }
         }
     }
-    fib_free(H);
 }
 
 /**
@@ -310,10 +437,19 @@ void dijkstra_fib(const Graph *g, int s, double *dist) {
  * The 'dist' array is pre-allocated by the wrapper.
  */
 void dijkstra_pair(const Graph *g, int s, double *dist) {
+    PairingHeap *H = pair_create(g->num_nodes);
+    dijkstra_pair_ws(g, s, dist, H);
+    pair_free(H);
+}
+
+/**
+ * The Pairing heap search loop, with a caller-owned heap
+ * (see dijkstra_fib_ws).
+ */
+void dijkstra_pair_ws(const Graph *g, int s, double *dist, PairingHeap *H) {
     int n = g->num_nodes;
     for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
 
-    PairingHeap *H = pair_create(n);
     dist[s] = 0.0;
     pair_insert(H, 0.0, s);
 
@@ -336,6 +472,277 @@ void dijkstra_pair(const Graph *g, int s, double *dist) {
             }
         }
     }
+}
+
+/*
+ * ======================================================================
+ * Point-to-Point Dijkstra with Optional Arc-Flag Pruning
+ * ======================================================================
+ * Same relaxation loop as above, but the search stops once the target
+ * is settled. With arc flags, only arcs flagged for the target's
+ * region are relaxed; arc ids follow adjacency-list order, so the id
+ * is tracked alongside the Edge pointer.
+ */
+
+double dijkstra_fib_p2p(const Graph *g, int s, int t, const ArcFlags *af,
+                        int *out_settled, long *out_scanned, long *out_pruned) {
+    int n = g->num_nodes;
+    double *dist = malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+
+    int rt = af ? af->region[t] : 0;
+    int settled = 0;
+    long scanned = 0, pruned = 0;
+
+    FibHeap *H = fib_create(n);
+    dist[s] = 0.0;
+    fib_insert(H, 0.0, s);
+
+    while (!fib_is_empty(H)) {
+        int u = fib_extract_min(H);
+        if (u == -1) break;
+        settled++;
+        if (u == t) break; // Target settled: its distance is final
+
+        long arc = af ? af->offset[u] : 0;
+        for (Edge *e = g->adj[u]; e; e = e->next, arc++) {
+            if (af && !arcflags_test(af, arc, rt)) {
+                pruned++;
+                continue;
+            }
+            scanned++;
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                fib_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    double result = dist[t];
+    fib_free(H);
+    free(dist);
+
+    if (out_settled) *out_settled = settled;
+    if (out_scanned) *out_scanned = scanned;
+    if (out_pruned) *out_pruned = pruned;
+    return result;
+}
+
+double dijkstra_pair_p2p(const Graph *g, int s, int t, const ArcFlags *af,
+                         int *out_settled, long *out_scanned, long *out_pruned) {
+    int n = g->num_nodes;
+    double *dist = malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+
+    int rt = af ? af->region[t] : 0;
+    int settled = 0;
+    long scanned = 0, pruned = 0;
+
+    PairingHeap *H = pair_create(n);
+    dist[s] = 0.0;
+    pair_insert(H, 0.0, s);
+
+    while (H->root) {
+        int u = pair_extract_min(H);
+        if (u == -1) break;
+        settled++;
+        if (u == t) break; // Target settled: its distance is final
+
+        long arc = af ? af->offset[u] : 0;
+        for (Edge *e = g->adj[u]; e; e = e->next, arc++) {
+            if (af && !arcflags_test(af, arc, rt)) {
+                pruned++;
+                continue;
+            }
+            scanned++;
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pair_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    double result = dist[t];
+    pair_free(H);
+    free(dist);
+
+    if (out_settled) *out_settled = settled;
+    if (out_scanned) *out_scanned = scanned;
+    if (out_pruned) *out_pruned = pruned;
+    return result;
+}
+
+/*
+ * ======================================================================
+ * Multi-Target Dijkstra
+ * ======================================================================
+ * One search answers every query that shares the source 's'. The
+ * search stops once the last distinct target has been settled.
+ */
+
+// Marks the distinct targets in 'is_target' and returns how many there are.
+static int mark_targets(const int *targets, int num_targets, char *is_target) {
+    int distinct = 0;
+    for (int i = 0; i < num_targets; i++) {
+        if (!is_target[targets[i]]) {
+            is_target[targets[i]] = 1;
+            distinct++;
+        }
+    }
+    return distinct;
+}
+
+int dijkstra_fib_targets(const Graph *g, int s, const int *targets, int num_targets, double *out) {
+    int n = g->num_nodes;
+    double *dist = malloc(n * sizeof(double));
+    char *is_target = calloc(n, 1);
+    for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+
+    int remaining = mark_targets(targets, num_targets, is_target);
+    int settled = 0;
+
+    FibHeap *H = fib_create(n);
+    dist[s] = 0.0;
+    fib_insert(H, 0.0, s);
+
+    while (!fib_is_empty(H) && remaining > 0) {
+        int u = fib_extract_min(H);
+        if (u == -1) break;
+        settled++;
+        if (is_target[u] && --remaining == 0) break; // Last target settled
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                fib_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    for (int i = 0; i < num_targets; i++) out[i] = dist[targets[i]];
+
+    fib_free(H);
+    free(is_target);
+    free(dist);
+    return settled;
+}
+
+int dijkstra_pair_targets(const Graph *g, int s, const int *targets, int num_targets, double *out) {
+    int n = g->num_nodes;
+    double *dist = malloc(n * sizeof(double));
+    char *is_target = calloc(n, 1);
+    for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+
+    int remaining = mark_targets(targets, num_targets, is_target);
+    int settled = 0;
+
+    PairingHeap *H = pair_create(n);
+    dist[s] = 0.0;
+    pair_insert(H, 0.0, s);
+
+    while (H->root && remaining > 0) {
+        int u = pair_extract_min(H);
+        if (u == -1) break;
+        settled++;
+        if (is_target[u] && --remaining == 0) break; // Last target settled
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pair_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    for (int i = 0; i < num_targets; i++) out[i] = dist[targets[i]];
 
     pair_free(H);
+    free(is_target);
+    free(dist);
+    return settled;
+}
+
+/*
+ * ======================================================================
+ * Budgeted Dijkstra
+ * ======================================================================
+ * Full SSSP kernels that stop early when a deadline passes or too many
+ * nodes have been settled. Reading the clock costs far more than an
+ * extraction, so the deadline is only checked every
+ * BUDGET_CHECK_INTERVAL extractions.
+ */
+
+// Returns 1 if the search must stop before settling its next node.
+static int budget_exhausted(const SearchBudget *b, long settled) {
+    if (!b) return 0;
+    if (b->max_settled > 0 && settled >= b->max_settled) return 1;
+    return b->deadline > 0 && settled % BUDGET_CHECK_INTERVAL == 0 && timer_now() > b->deadline;
+}
+
+int dijkstra_fib_budget(const Graph *g, int s, int t, double *dist, FibHeap *H,
+                        const SearchBudget *budget) {
+    dist[s] = 0.0;
+    fib_insert(H, 0.0, s);
+
+    long settled = 0;
+    int completed = 1;
+    while (!fib_is_empty(H)) {
+        if (budget_exhausted(budget, settled)) {
+            completed = 0;
+            break;
+        }
+        int u = fib_extract_min(H);
+        if (u == -1 || u == t) break;
+        settled++;
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                fib_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    fib_clear(H); // Drops the nodes left behind by an abort
+    return completed;
+}
+
+int dijkstra_pair_budget(const Graph *g, int s, int t, double *dist, PairingHeap *H,
+                         const SearchBudget *budget) {
+    dist[s] = 0.0;
+    pair_insert(H, 0.0, s);
+
+    long settled = 0;
+    int completed = 1;
+    while (H->root) {
+        if (budget_exhausted(budget, settled)) {
+            completed = 0;
+            break;
+        }
+        int u = pair_extract_min(H);
+        if (u == -1 || u == t) break;
+        settled++;
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pair_decrease_key(H, v, nd);
+            }
+        }
+    }
+
+    pair_clear(H);
+    return completed;
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "dynsssp.h"
+#include "memtrack.h"
+
+/**
+ * Runs Dijkstra from the nodes currently in the heap, lowering labels
+ * and tree parents. Returns the number of settled nodes.
+ */
+static long propagate(DynamicSSSP *d) {
+    const Graph *g = d->g;
+    double *dist = d->dist;
+    long settled = 0;
+
+    while (d->heap->root) {
+        int u = pair_extract_min(d->heap);
+        if (u == -1) break;
+        settled++;
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                d->parent[v] = u;
+                pair_decrease_key(d->heap, v, nd);
+            }
+        }
+    }
+    return settled;
+}
+
+DynamicSSSP* dyn_create(Graph *g, int s) {
+    int n = g->num_nodes;
+    DynamicSSSP *d = xmalloc(sizeof(DynamicSSSP));
+    d->g = g;
+    d->source = s;
+    d->dist = xmalloc(n * sizeof(double));
+    d->parent = xmalloc(n * sizeof(int));
+    d->affected = xcalloc(n > 0 ? n : 1, 1);
+    d->stack = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    d->heap = pair_create(n);
+    if (!d->heap) {
+        fprintf(stderr, "Error: dynamic SSSP heap allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        d->dist[i] = DBL_MAX;
+        d->parent[i] = -1;
+    }
+    if (s >= 0 && s < n) {
+        d->dist[s] = 0.0;
+        pair_insert(d->heap, 0.0, s);
+        propagate(d);
+    }
+    return d;
+}
+
+/**
+ * Marks the tree subtree rooted at 'root' as affected and appends its
+ * nodes to the stack. Children of x are found by scanning x's out-arcs
+ * for nodes whose parent is x, so no child lists are needed.
+ */
+static int mark_subtree(DynamicSSSP *d, int root, int top) {
+    if (d->affected[root]) return top;
+    d->affected[root] = 1;
+    int first = top;
+    d->stack[top++] = root;
+    // The stack doubles as the BFS queue: [first, top) grows as we scan
+    for (int i = first; i < top; i++) {
+        int x = d->stack[i];
+        for (Edge *e = d->g->adj[x]; e; e = e->next) {
+            int y = e->to;
+            if (!d->affected[y] && d->parent[y] == x) {
+                d->affected[y] = 1;
+                d->stack[top++] = y;
+            }
+        }
+    }
+    return top;
+}
+
+long dyn_update(DynamicSSSP *d, const WeightChange *changes, int k) {
+    Graph *g = d->g;
+    double *dist = d->dist;
+    int n = g->num_nodes;
+    int top = 0;
+
+    // 1. Apply the changes; increased tree arcs cut off their subtree
+    for (int i = 0; i < k; i++) {
+        int u = changes[i].u, v = changes[i].v;
+        if (u < 0 || v < 0 || u >= n || v >= n) continue;
+        Edge *e = g->adj[u];
+        while (e && e->to != v) e = e->next;
+        if (!e) continue;
+        double old = e->weight;
+        update_edge_weight(g, u, v, changes[i].weight);
+        if (changes[i].weight > old && d->parent[v] == u)
+            top = mark_subtree(d, v, top);
+    }
+
+    // 2. Affected nodes restart from their best unaffected in-neighbour
+    for (int i = 0; i < top; i++) {
+        int y = d->stack[i];
+        dist[y] = DBL_MAX;
+        d->parent[y] = -1;
+    }
+    for (int i = 0; i < top; i++) {
+        int y = d->stack[i];
+        for (Edge *r = g->rev_adj[y]; r; r = r->next) {
+            int x = r->to;
+            if (d->affected[x] || dist[x] == DBL_MAX) continue;
+            double nd = dist[x] + r->weight;
+            if (nd < dist[y]) {
+                dist[y] = nd;
+                d->parent[y] = x;
+            }
+        }
+        if (dist[y] < DBL_MAX) pair_insert(d->heap, dist[y], y);
+    }
+    for (int i = 0; i < top; i++) d->affected[d->stack[i]] = 0;
+
+    // 3. Decreased arcs may open shorter paths
+    for (int i = 0; i < k; i++) {
+        int u = changes[i].u, v = changes[i].v;
+        if (u < 0 || v < 0 || u >= n || v >= n || dist[u] == DBL_MAX) continue;
+        double nd = dist[u] + changes[i].weight;
+        if (nd < dist[v]) {
+            // Only valid if the change hit an arc (update_edge_weight may have failed)
+            Edge *e = g->adj[u];
+            while (e && e->to != v) e = e->next;
+            if (!e || e->weight != changes[i].weight) continue;
+            dist[v] = nd;
+            d->parent[v] = u;
+            pair_decrease_key(d->heap, v, nd);
+        }
+    }
+
+    return propagate(d);
+}
+
+void dyn_free(DynamicSSSP *d) {
+    if (!d) return;
+    free(d->dist);
+    free(d->parent);
+    free(d->affected);
+    free(d->stack);
+    pair_free(d->heap);
+    free(d);
+}
@@ -3,6 +3,7 @@
 #include <float.h>
 #include <stdbool.h>
 #include <math.h>
+#include <string.h>
 #include "fibheap.h"
 
 // Internal representation of a node in the Fibonacci heap
@@ -28,12 +29,16 @@ struct FibHeap {
      * This is essential for an O(1) lookup time during decrease_key.
      */
     FibNode **map;
+    MemCounter mem;     // Bytes allocated by this heap (see memtrack.h)
+#ifdef HEAP_STATS
+    HeapStats stats;    // Operation counters (see heapstats.h)
+#endif
 };
 
 // --- Static Helper Function Prototypes ---
 
 // Allocates and initializes a new heap node
-static FibNode* fib_new_node(int node, double key);
+static FibNode* fib_new_node(FibHeap *H, int node, double key);
 // Links node y as a child of node x
 static void fib_link(FibHeap *H, FibNode *y, FibNode *x);
 // Consolidates the root list to ensure unique tree degrees
@@ -42,8 +47,8 @@ static void fib_consolidate(FibHeap *H);
 static void fib_cut(FibHeap *H, FibNode *x, FibNode *y);
 // Performs a cascading cut, moving up from a node
 static void fib_cascading_cut(FibHeap *H, FibNode *y);
-// Recursively frees a node and its entire subtree
-static void fib_free_node(FibNode *node);
+// Recursively frees a node and its entire subtree, clearing their map slots
+static void fib_free_node(FibHeap *H, FibNode *node);
 
 
 // --- Public API Functions ---
@@ -55,9 +60,13 @@ FibHeap* fib_create(int max_nodes) {
     H->min = NULL;
     H->n = 0;
     H->max_nodes = max_nodes;
+#ifdef HEAP_STATS
+    memset(&H->stats, 0, sizeof(HeapStats));
+#endif
     
     // Allocate the map for O(1) node access
-    H->map = (FibNode**)calloc(max_nodes, sizeof(FibNode*));
+    mem_init(&H->mem);
+    H->map = (FibNode**)mem_calloc(&H->mem, max_nodes, sizeof(FibNode*));
     if (!H->map) {
         free(H);
         return NULL;
@@ -79,9 +88,10 @@ void fib_insert(FibHeap *H, double key, int node) {
     }
     
     // Create a new node and add it to the map
-    FibNode *x = fib_new_node(node, key);
+    FibNode *x = fib_new_node(H, node, key);
     if (!x) return; // Allocation failure
     H->map[node] = x;
+    HEAP_STAT(H->stats.inserts++);
     
     if (H->min == NULL) {
         // This is the first node in the heap
@@ -104,6 +114,7 @@ void fib_insert(FibHeap *H, double key, int node) {
 int fib_extract_min(FibHeap *H) {
     FibNode *z = H->min;
     if (z == NULL) return -1; // Heap is empty
+    HEAP_STAT(H->stats.extract_mins++);
     
     // Promote all children of the min node to the root list
     if (z->child != NULL) {
@@ -139,7 +150,7 @@ int fib_extract_min(FibHeap *H) {
     
     int result = z->node;
     H->map[result] = NULL; // Remove from map
-    free(z);
+    mem_free_object(&H->mem, z, sizeof(FibNode));
     H->n--;
     
     return result;
@@ -161,14 +172,17 @@ void fib_decrease_key(FibHeap *H, int node, double new_key) {
     
     if (new_key > x->key) {
         // New key is larger, this is not a valid decrease-key operation
+        HEAP_STAT(H->stats.decrease_noops++);
         return;
     }
+    HEAP_STAT(if (new_key < x->key) H->stats.decrease_keys++; else H->stats.decrease_noops++);
     
     x->key = new_key;
     FibNode *y = x->parent;
     
     // If the heap property is now violated (child < parent)
     if (y != NULL && x->key < y->key) {
+        HEAP_STAT(H->stats.cuts++);
         fib_cut(H, x, y);
         fib_cascading_cut(H, y);
     }
@@ -179,28 +193,52 @@ void fib_decrease_key(FibHeap *H, int node, double new_key) {
     }
 }
 
+void fib_clear(FibHeap *H) {
+    if (H == NULL || H->min == NULL) return;
+
+    fib_free_node(H, H->min);
+    H->min = NULL;
+    H->n = 0;
+}
+
 bool fib_is_empty(FibHeap *H) {
     return H->min == NULL;
 }
 
+int fib_take_stats(FibHeap *H, HeapStats *out) {
+#ifdef HEAP_STATS
+    *out = H->stats;
+    memset(&H->stats, 0, sizeof(HeapStats));
+    return 1;
+#else
+    (void)H;
+    memset(out, 0, sizeof(HeapStats));
+    return 0;
+#endif
+}
+
+void fib_memory(FibHeap *H, MemCounter *out) {
+    *out = H->mem;
+}
+
 void fib_free(FibHeap *H) {
     if (H == NULL) return;
     
     // Free all nodes in the heap
     if (H->min != NULL) {
-        fib_free_node(H->min);
+        fib_free_node(H, H->min);
     }
     
     // Free the map and the heap structure itself
-    free(H->map);
+    mem_free(&H->mem, H->map, (size_t)H->max_nodes * sizeof(FibNode*));
     free(H);
 }
 
 
 // --- Static Helper Function Implementations ---
 
-static FibNode* fib_new_node(int node, double key) {
-    FibNode *x = (FibNode*)malloc(sizeof(FibNode));
+static FibNode* fib_new_node(FibHeap *H, int node, double key) {
+    FibNode *x = (FibNode*)mem_new_object(&H->mem, sizeof(FibNode));
     if (!x) return NULL;
     
     x->node = node;
@@ -237,6 +275,8 @@ static void fib_link(FibHeap *H, FibNode *y, FibNode *x) {
     
     // 3. Update x's degree
     x->degree++;
+    HEAP_STAT(H->stats.links++;
+              if (x->degree > H->stats.max_degree) H->stats.max_degree = x->degree);
     
     // 4. Unmark y (it just became a child)
     y->mark = false;
@@ -250,7 +290,7 @@ static void fib_consolidate(FibHeap *H) {
     int max_degree = (int)(log(H->n) / log(2)) + 2;
     
     // A is an array of pointers to trees, indexed by degree
-    FibNode **A = (FibNode**)calloc(max_degree + 1, sizeof(FibNode*));
+    FibNode **A = (FibNode**)mem_calloc(&H->mem, max_degree + 1, sizeof(FibNode*));
     if (!A) return; // Allocation failure
     
     // Count nodes in the root list to avoid infinite loops
@@ -262,6 +302,8 @@ static void fib_consolidate(FibHeap *H) {
         root_count++;
         current = current->right;
     } while (current != w);
+    HEAP_STAT(H->stats.root_list_total += root_count;
+              if (root_count > H->stats.root_list_max) H->stats.root_list_max = root_count);
     
     // Iterate through all nodes in the root list
     for (int i = 0; i < root_count; i++) {
@@ -315,7 +357,7 @@ static void fib_consolidate(FibHeap *H) {
         }
     }
     
-    free(A);
+    mem_free(&H->mem, A, (max_degree + 1) * sizeof(FibNode*));
 }
 
 static void fib_cut(FibHeap *H, FibNode *x, FibNode *y) {
@@ -358,6 +400,7 @@ static void fib_cascading_cut(FibHeap *H, FibNode *y) {
         } else {
             // If y is marked, it has now lost a second child.
             // Cut y from its parent z and move it to the root list.
+            HEAP_STAT(H->stats.cascading_cuts++);
             fib_cut(H, y, z);
             // Recurse up the tree
             fib_cascading_cut(H, z);
@@ -365,7 +408,7 @@ static void fib_cascading_cut(FibHeap *H, FibNode *y) {
     }
 }
 
-static void fib_free_node(FibNode *node) {
+static void fib_free_node(FibHeap *H, FibNode *node) {
     if (node == NULL) return;
     
     // Iterate through the circular list and free all nodes
@@ -376,10 +419,11 @@ static void fib_free_node(FibNode *node) {
         
         // Recursively free the child list
         if (current->child != NULL) {
-            fib_free_node(current->child);
+            fib_free_node(H, current->child);
         }
         
-        free(current);
+        H->map[current->node] = NULL;
+        mem_free_object(&H->mem, current, sizeof(FibNode));
         current = next;
     } while (current != start); // Stop when we've looped back
 }
\ No newline at end of file
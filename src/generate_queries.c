@@ -3,7 +3,10 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <float.h>
 #include "graph.h"
+#include "fibheap.h"
+#include "generate_queries.h"
 
 // Platform-specific includes and definitions for directory creation
 #ifdef _WIN32
@@ -244,10 +247,18 @@ void generate_small_test_queries(const char* folder, Graph* g) {
         int used[20] = {0}; // Track which pairs have been used
         int generated = 0;
         
+        // Count the pairs inside the graph so small graphs cannot loop forever
+        int valid = 0;
+        for (int i = 0; i < total_pairs; i++) {
+            int s = predefined_pairs[i][0];
+            int t = predefined_pairs[i][1];
+            if (s >= 0 && s < g->num_nodes && t >= 0 && t < g->num_nodes) valid++;
+        }
+        
         srand(time(NULL));
         
         // Randomly select 10 unique pairs from the predefined list
-        while (generated < 10 && generated < total_pairs) {
+        while (generated < 10 && generated < valid) {
             int idx = rand() % total_pairs;
             if (!used[idx]) {
                 int s = predefined_pairs[idx][0];
@@ -367,6 +378,535 @@ void generate_edge_case_queries(const char* folder, Graph* g) {
     }
 }
 
+/**
+ * Runs Dijkstra from 's' and stores the nodes in the order they are
+ * settled: order[r] is the node of Dijkstra rank r (order[0] = s).
+ * Returns the number of settled nodes.
+ */
+static int settle_order(Graph* g, int s, double* dist, int* order) {
+    for (int i = 0; i < g->num_nodes; i++) dist[i] = DBL_MAX;
+    FibHeap* H = fib_create(g->num_nodes);
+    dist[s] = 0.0;
+    fib_insert(H, 0.0, s);
+
+    int count = 0;
+    while (!fib_is_empty(H)) {
+        int u = fib_extract_min(H);
+        if (u == -1) break;
+        order[count++] = u;
+        for (Edge* e = g->adj[u]; e; e = e->next) {
+            double nd = dist[u] + e->weight;
+            if (nd < dist[e->to]) {
+                dist[e->to] = nd;
+                fib_decrease_key(H, e->to, nd);
+            }
+        }
+    }
+    fib_free(H);
+    return count;
+}
+
+/*
+ * Seeded generator for the workload files below. rand() is not used
+ * because RAND_MAX may be as small as 32767 and its sequence differs
+ * between C libraries, so the same seed would not give the same file.
+ */
+static unsigned long long rng_state = 1;
+static unsigned int generator_seed = 12345;
+
+void set_generator_seed(unsigned int seed) {
+    generator_seed = seed;
+}
+
+static void rng_seed(unsigned int seed) {
+    rng_state = seed;
+}
+
+// splitmix64
+static unsigned long long rng_next(void) {
+    unsigned long long z = (rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform integer in [0, n).
+static int rng_below(int n) {
+    return (int)(rng_next() % (unsigned long long)n);
+}
+
+// Uniform double in [0, 1).
+static double rng_uniform(void) {
+    return (rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Returns the first index i with cdf[i] > x (cdf is non-decreasing).
+static int cdf_search(const double* cdf, int n, double x) {
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (cdf[mid] > x) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+/**
+ * Generates a Dijkstra-rank workload: for 'num_sources' random sources,
+ * one SSSP is run and the nodes settled at ranks 2^1, 2^2, ... become
+ * targets. Each line is "s t i" with rank 2^i, so query difficulty is
+ * spread evenly from local to continent-scale.
+ * Unlike the uniform files, node ids are written 1-based (DIMACS ids),
+ * which is what the benchmark's query loader expects. Sources come from
+ * the seeded generator, so the same seed always gives the same file.
+ */
+void generate_rank_queries(const char* folder, Graph* g, int num_sources,
+                           unsigned int seed) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s/dijkstra_rank_queries_%d.txt", folder, num_sources);
+
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Failed to create Dijkstra rank queries file: %s\n", filename);
+        return;
+    }
+    if (g->num_nodes < 2) {
+        printf("Graph has less than 2 nodes, creating empty Dijkstra rank queries file\n");
+        fclose(fp);
+        return;
+    }
+
+    double* dist = malloc(g->num_nodes * sizeof(double));
+    int* order = malloc(g->num_nodes * sizeof(int));
+    rng_seed(seed + 4);
+    int generated = 0;
+    printf("Generating Dijkstra rank queries...\n");
+
+    for (int k = 0; k < num_sources; k++) {
+        int s = rng_below(g->num_nodes);
+        int settled = settle_order(g, s, dist, order);
+        for (int i = 1; (1L << i) < settled; i++) {
+            fprintf(fp, "%d %d %d\n", s + 1, order[1L << i] + 1, i);
+            generated++;
+        }
+        printf("  Source %d/%d: %d nodes settled\n", k + 1, num_sources, settled);
+    }
+
+    free(dist);
+    free(order);
+    fclose(fp);
+    printf("Generated Dijkstra rank queries: %s (%d pairs)\n", filename, generated);
+}
+
+/**
+ * Generates 'count' uniform random pairs (s != t) into folder/filename.
+ * The same seed always gives the same file. Ids are 1-based.
+ */
+void generate_custom_queries(const char* folder, Graph* g, int count,
+                            const char* filename, unsigned int seed) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", folder, filename);
+
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        printf("Failed to create custom queries file: %s\n", path);
+        return;
+    }
+    int generated = 0;
+    if (g->num_nodes >= 2) {
+        printf("Generating custom queries (seed %u)...\n", seed);
+        rng_seed(seed);
+        while (generated < count) {
+            int s = rng_below(g->num_nodes);
+            int t = rng_below(g->num_nodes);
+            if (s == t) continue;
+            fprintf(fp, "%d %d\n", s + 1, t + 1);
+            generated++;
+        }
+    } else {
+        printf("Graph has less than 2 nodes, creating empty custom queries file\n");
+    }
+    fclose(fp);
+    printf("Generated custom queries: %s (%d pairs)\n", path, generated);
+}
+
+/**
+ * Generates 'count' pairs whose endpoints are drawn in proportion to
+ * their out-degree if 'degree_weighted' is non-zero (busy junctions are
+ * queried more often), or uniformly among nodes with at least one
+ * out-arc otherwise. Seeded by set_generator_seed. Ids are 1-based.
+ */
+void generate_degree_weighted_queries(const char* folder, Graph* g,
+                                     int count, int degree_weighted) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s/degree_weighted_queries_%d.txt", folder, count);
+
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Failed to create degree weighted queries file: %s\n", filename);
+        return;
+    }
+
+    // Prefix sums of the node weights (degree or 1 for non-isolated nodes)
+    int n = g->num_nodes;
+    double* cdf = malloc((n > 0 ? n : 1) * sizeof(double));
+    double total = 0;
+    int candidates = 0;
+    for (int i = 0; i < n; i++) {
+        int degree = 0;
+        for (Edge* e = g->adj[i]; e; e = e->next) degree++;
+        if (degree > 0) candidates++;
+        total += degree_weighted ? degree : (degree > 0);
+        cdf[i] = total;
+    }
+
+    int generated = 0;
+    if (candidates >= 2) {
+        printf("Generating %s queries...\n", degree_weighted ? "degree weighted" : "non-isolated uniform");
+        rng_seed(generator_seed + 1);
+        while (generated < count) {
+            int s = cdf_search(cdf, n, rng_uniform() * total);
+            int t = cdf_search(cdf, n, rng_uniform() * total);
+            if (s == t) continue;
+            fprintf(fp, "%d %d\n", s + 1, t + 1);
+            generated++;
+        }
+    } else {
+        printf("Graph has less than 2 nodes with out-arcs, creating empty degree weighted file\n");
+    }
+    free(cdf);
+    fclose(fp);
+    printf("Generated degree weighted queries: %s (%d pairs)\n", filename, generated);
+}
+
+/**
+ * Runs Dijkstra from 's' until the next node is farther than 'limit'
+ * and stores the settled nodes in 'order'. 'dist' must be all DBL_MAX
+ * and 'H' empty; both are restored before returning (only the touched
+ * entries are reset), so repeated calls cost O(ball size), not O(n).
+ * 'touched' needs room for n entries. Returns the number of settled nodes.
+ */
+static int settle_within(Graph* g, int s, double limit, double* dist, int* order,
+                         int* touched, FibHeap* H) {
+    int num_touched = 0;
+    dist[s] = 0.0;
+    touched[num_touched++] = s;
+    fib_insert(H, 0.0, s);
+
+    int count = 0;
+    while (!fib_is_empty(H)) {
+        int u = fib_extract_min(H);
+        if (u == -1 || dist[u] > limit) break;
+        order[count++] = u;
+        for (Edge* e = g->adj[u]; e; e = e->next) {
+            double nd = dist[u] + e->weight;
+            if (nd < dist[e->to]) {
+                if (dist[e->to] == DBL_MAX) touched[num_touched++] = e->to;
+                dist[e->to] = nd;
+                fib_decrease_key(H, e->to, nd);
+            }
+        }
+    }
+    fib_clear(H);
+    for (int i = 0; i < num_touched; i++) dist[touched[i]] = DBL_MAX;
+    return count;
+}
+
+/**
+ * Generates 'count' local queries: t is drawn uniformly among the nodes
+ * within network distance 'max_distance' of a random s (the graph has
+ * no coordinates, so "spatial" means shortest-path distance). Sources
+ * with no such node are redrawn. Seeded by set_generator_seed.
+ * Ids are 1-based.
+ */
+void generate_spatial_queries(const char* folder, Graph* g, int count,
+                             double max_distance) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s/spatial_queries_%d_%g.txt", folder, count, max_distance);
+
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Failed to create spatial queries file: %s\n", filename);
+        return;
+    }
+    if (g->num_nodes < 2) {
+        printf("Graph has less than 2 nodes, creating empty spatial queries file\n");
+        fclose(fp);
+        return;
+    }
+
+    int n = g->num_nodes;
+    double* dist = malloc(n * sizeof(double));
+    int* order = malloc(n * sizeof(int));
+    int* touched = malloc(n * sizeof(int));
+    FibHeap* H = fib_create(n);
+    for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+
+    rng_seed(generator_seed + 2);
+    int generated = 0;
+    int attempts = 0;
+    const int MAX_ATTEMPTS = count * 100;
+    long ball_total = 0;
+    printf("Generating spatial queries (radius %g)...\n", max_distance);
+
+    while (generated < count && attempts < MAX_ATTEMPTS) {
+        attempts++;
+        int s = rng_below(n);
+        int settled = settle_within(g, s, max_distance, dist, order, touched, H);
+        if (settled < 2) continue; // Nothing but s within the radius
+        int t = order[1 + rng_below(settled - 1)];
+        fprintf(fp, "%d %d\n", s + 1, t + 1);
+        ball_total += settled;
+        generated++;
+        if (generated % 1000 == 0) {
+            printf("  Generated %d/%d spatial queries...\n", generated, count);
+        }
+    }
+
+    fib_free(H);
+    free(dist);
+    free(order);
+    free(touched);
+    fclose(fp);
+    printf("Generated spatial queries: %s (%d pairs, %d attempts, %.1f nodes per ball)\n",
+           filename, generated, attempts, generated > 0 ? (double)ball_total / generated : 0.0);
+    if (generated < count) {
+        printf("Warning: Only generated %d out of %d queries (max attempts reached)\n", generated, count);
+    }
+}
+
+/**
+ * Generates 'count' queries whose sources follow a Zipf law over
+ * 'num_hot' random hot nodes: the k-th hot node is the source with
+ * probability proportional to 1 / k^exponent, so a few sources carry
+ * most of the traffic, as in production request logs. Targets are
+ * uniform. Ids are 1-based.
+ */
+void generate_zipf_queries(const char* folder, Graph* g, int count, int num_hot,
+                           double exponent, unsigned int seed) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s/zipf_queries_%d.txt", folder, count);
+
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Failed to create Zipf queries file: %s\n", filename);
+        return;
+    }
+    if (g->num_nodes < 2 || num_hot < 1) {
+        printf("Graph has less than 2 nodes, creating empty Zipf queries file\n");
+        fclose(fp);
+        return;
+    }
+    if (num_hot > g->num_nodes) num_hot = g->num_nodes;
+
+    rng_seed(seed);
+    int* hot = malloc(num_hot * sizeof(int));
+    double* cdf = malloc(num_hot * sizeof(double));
+    double total = 0;
+    for (int k = 0; k < num_hot; k++) {
+        hot[k] = rng_below(g->num_nodes); // Repeats only merge some ranks
+        total += 1.0 / pow(k + 1, exponent);
+        cdf[k] = total;
+    }
+
+    printf("Generating Zipf queries (%d hot sources, exponent %g, seed %u)...\n", num_hot, exponent, seed);
+    int generated = 0;
+    while (generated < count) {
+        int s = hot[cdf_search(cdf, num_hot, rng_uniform() * total)];
+        int t = rng_below(g->num_nodes);
+        if (s == t) continue;
+        fprintf(fp, "%d %d\n", s + 1, t + 1);
+        generated++;
+    }
+
+    free(hot);
+    free(cdf);
+    fclose(fp);
+    printf("Generated Zipf queries: %s (%d pairs, top source %.1f%% of traffic)\n",
+           filename, generated, 100.0 / total);
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Prints mean and percentiles of 'n' values (sorted in place).
+static void print_distribution(const char* name, double* v, int n) {
+    if (n == 0) {
+        printf("  %-10s (no reachable sampled queries)\n", name);
+        return;
+    }
+    qsort(v, n, sizeof(double), cmp_double);
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += v[i];
+    printf("  %-10s mean %.1f, min %.0f, p10 %.0f, p50 %.0f, p90 %.0f, p99 %.0f, max %.0f\n",
+           name, sum / n, v[0], v[n / 10], v[n / 2], v[(int)(n * 0.9)], v[(int)(n * 0.99)], v[n - 1]);
+}
+
+/**
+ * Prints the profile of a query file as the benchmark will see it (ids
+ * 1-based): source skew, and the hop and distance distributions of the
+ * queries of up to ANALYZE_SAMPLE_SOURCES sampled sources. The sampled
+ * SSSPs run in parallel with OpenMP; each also reports how many nodes a
+ * full search from that source settles.
+ */
+void analyze_query_file(const char* folder, const char* filename, Graph* g) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", folder, filename);
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("Cannot open query file: %s\n", path);
+        return;
+    }
+
+    int n = g->num_nodes;
+    int cap = 1024, count = 0, invalid = 0;
+    int* qs = malloc(cap * sizeof(int));
+    int* qt = malloc(cap * sizeof(int));
+    char line[256];
+    int s, t;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%d %d", &s, &t) != 2) continue;
+        s--; t--;
+        if (s < 0 || s >= n || t < 0 || t >= n) {
+            invalid++;
+            continue;
+        }
+        if (count == cap) {
+            cap *= 2;
+            qs = realloc(qs, cap * sizeof(int));
+            qt = realloc(qt, cap * sizeof(int));
+        }
+        qs[count] = s;
+        qt[count] = t;
+        count++;
+    }
+    fclose(fp);
+
+    printf("\nAnalysis of %s: %d queries", filename, count);
+    if (invalid > 0) printf(" (%d out of range skipped)", invalid);
+    printf("\n");
+    if (count == 0) {
+        free(qs);
+        free(qt);
+        return;
+    }
+
+    // Source skew: distinct sources and the busiest one
+    int* sorted = malloc(count * sizeof(int));
+    memcpy(sorted, qs, count * sizeof(int));
+    qsort(sorted, count, sizeof(int), cmp_int);
+    int distinct = 0, top = 0, top_count = 0;
+    for (int i = 0; i < count;) {
+        int j = i;
+        while (j < count && sorted[j] == sorted[i]) j++;
+        distinct++;
+        if (j - i > top_count) {
+            top_count = j - i;
+            top = sorted[i];
+        }
+        i = j;
+    }
+    int self_loops = 0;
+    for (int i = 0; i < count; i++) if (qs[i] == qt[i]) self_loops++;
+    printf("  Sources: %d distinct, busiest %d with %.1f%% of queries; %d self-loops\n",
+           distinct, top + 1, 100.0 * top_count / count, self_loops);
+
+    // Sample distinct sources (every k-th in sorted order, so it is reproducible)
+    int num_samples = distinct < ANALYZE_SAMPLE_SOURCES ? distinct : ANALYZE_SAMPLE_SOURCES;
+    int* sample = malloc(num_samples * sizeof(int));
+    for (int k = 0, d = 0, i = 0; i < count && k < num_samples; d++) {
+        if ((long)d * num_samples / distinct == k) sample[k++] = sorted[i];
+        int j = i;
+        while (j < count && sorted[j] == sorted[i]) j++;
+        i = j;
+    }
+    free(sorted);
+
+    // Results per query; queries of unsampled sources stay at -1
+    double* qdist = malloc(count * sizeof(double));
+    int* qhops = malloc(count * sizeof(int));
+    long* settled = calloc(num_samples, sizeof(long));
+    for (int i = 0; i < count; i++) qhops[i] = -1;
+
+    #pragma omp parallel
+    {
+        double* dist = malloc(n * sizeof(double));
+        int* hops = malloc(n * sizeof(int));
+        FibHeap* H = fib_create(n);
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int k = 0; k < num_samples; k++) {
+            int src = sample[k];
+            for (int v = 0; v < n; v++) dist[v] = DBL_MAX;
+            dist[src] = 0.0;
+            hops[src] = 0;
+            fib_insert(H, 0.0, src);
+            while (!fib_is_empty(H)) {
+                int u = fib_extract_min(H);
+                if (u == -1) break;
+                settled[k]++;
+                for (Edge* e = g->adj[u]; e; e = e->next) {
+                    double nd = dist[u] + e->weight;
+                    if (nd < dist[e->to]) {
+                        dist[e->to] = nd;
+                        hops[e->to] = hops[u] + 1; // Hops along the shortest path tree
+                        fib_decrease_key(H, e->to, nd);
+                    }
+                }
+            }
+            // Each query belongs to exactly one source, so there are no write races
+            for (int i = 0; i < count; i++) {
+                if (qs[i] != src) continue;
+                qdist[i] = dist[qt[i]];
+                qhops[i] = (dist[qt[i]] < DBL_MAX) ? hops[qt[i]] : -2;
+            }
+        }
+
+        fib_free(H);
+        free(dist);
+        free(hops);
+    }
+
+    int sampled = 0, unreachable = 0, reachable = 0;
+    double* dv = malloc(count * sizeof(double));
+    double* hv = malloc(count * sizeof(double));
+    for (int i = 0; i < count; i++) {
+        if (qhops[i] == -1) continue;
+        sampled++;
+        if (qhops[i] == -2) {
+            unreachable++;
+            continue;
+        }
+        dv[reachable] = qdist[i];
+        hv[reachable] = qhops[i];
+        reachable++;
+    }
+    double settled_total = 0;
+    for (int k = 0; k < num_samples; k++) settled_total += settled[k];
+
+    printf("  Sample: %d sources, %d queries (%d unreachable)\n", num_samples, sampled, unreachable);
+    print_distribution("Hops:", hv, reachable);
+    print_distribution("Distance:", dv, reachable);
+    printf("  Full SSSP from a sampled source settles %.0f of %d nodes on average\n",
+           settled_total / num_samples, n);
+
+    free(qs);
+    free(qt);
+    free(sample);
+    free(qdist);
+    free(qhops);
+    free(settled);
+    free(dv);
+    free(hv);
+}
+
 /**
  * Validates a query file by checking all (s, t) pairs.
  * Ensures that 0 <= s < num_nodes and 0 <= t < num_nodes.
@@ -403,18 +943,43 @@ int validate_query_file(const char* folder, const char* filename, Graph* g) {
     return valid_pairs;
 }
 
+/**
+ * Default radius for the spatial workload: the distance from a random
+ * source to its SPATIAL_BALL_NODES-th settled node, so a typical ball
+ * holds about that many candidate targets whatever the graph's units.
+ */
+#define SPATIAL_BALL_NODES 1000
+
+static double default_spatial_radius(Graph* g, unsigned int seed) {
+    double* dist = malloc(g->num_nodes * sizeof(double));
+    int* order = malloc(g->num_nodes * sizeof(int));
+    rng_seed(seed + 3);
+    int settled = settle_order(g, rng_below(g->num_nodes), dist, order);
+    int rank = (settled - 1 < SPATIAL_BALL_NODES) ? settled - 1 : SPATIAL_BALL_NODES;
+    double radius = dist[order[rank]];
+    free(dist);
+    free(order);
+    return radius;
+}
+
 /**
  * Main entry point for the query generation executable.
  */
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        printf("Usage: %s <graph_file> <queries_folder>\n", argv[0]);
+    if (argc < 3) {
+        printf("Usage: %s <graph_file> <queries_folder> [rank_sources=20] [seed=time] [analyze=0|1]\n", argv[0]);
         printf("Example: %s data/USA-road-d.USA.gr Queries\n", argv[0]);
         return 1;
     }
     
     const char* graph_file = argv[1];
     const char* queries_folder = argv[2];
+    // Each rank source costs one full SSSP
+    int rank_sources = (argc >= 4) ? atoi(argv[3]) : 20;
+    // Seed of the workload files; print it so a run can be reproduced
+    unsigned int seed = (argc >= 5) ? (unsigned int)strtoul(argv[4], NULL, 10) : (unsigned int)time(NULL);
+    // Analysis runs ANALYZE_SAMPLE_SOURCES full SSSPs per workload file
+    int analyze = (argc >= 6) ? atoi(argv[5]) : 0;
     
     // Create the target directory if it doesn't exist
     create_directory(queries_folder);
@@ -441,6 +1006,15 @@ int main(int argc, char* argv[]) {
     generate_large_scale_queries(queries_folder, g, 10000);
     generate_edge_case_queries(queries_folder, g);
     
+    printf("\nWorkload seed: %u\n", seed);
+    set_generator_seed(seed);
+    if (rank_sources > 0) generate_rank_queries(queries_folder, g, rank_sources, seed);
+    generate_custom_queries(queries_folder, g, 1000, "custom_queries_1000.txt", seed);
+    generate_degree_weighted_queries(queries_folder, g, 1000, 1);
+    double radius = (g->num_nodes >= 2) ? default_spatial_radius(g, seed) : 0;
+    generate_spatial_queries(queries_folder, g, 1000, radius);
+    generate_zipf_queries(queries_folder, g, 1000, 100, 1.0, seed);
+    
     printf("\n==========================================\n");
     printf("All query files generated successfully!\n");
     
@@ -450,6 +1024,20 @@ int main(int argc, char* argv[]) {
     validate_query_file(queries_folder, "large_scale_queries_10000.txt", g);
     validate_query_file(queries_folder, "small_test_queries_10.txt", g);
     
+    if (analyze) {
+        char spatial_file[256];
+        snprintf(spatial_file, sizeof(spatial_file), "spatial_queries_%d_%g.txt", 1000, radius);
+        analyze_query_file(queries_folder, "custom_queries_1000.txt", g);
+        analyze_query_file(queries_folder, "degree_weighted_queries_1000.txt", g);
+        analyze_query_file(queries_folder, spatial_file, g);
+        analyze_query_file(queries_folder, "zipf_queries_1000.txt", g);
+        if (rank_sources > 0) {
+            char rank_file[256];
+            snprintf(rank_file, sizeof(rank_file), "dijkstra_rank_queries_%d.txt", rank_sources);
+            analyze_query_file(queries_folder, rank_file, g);
+        }
+    }
+    
     free_graph(g);
     return 0;
 }
\ No newline at end of file
@@ -5,11 +5,11 @@
 
 /**
  * A static helper function to add an edge to an adjacency list.
- * Allocates a new Edge node and prepends it to the list
- * for the 'from' node. Exits on allocation failure.
+ * Allocates a new Edge node (counted in g->mem) and prepends it to
+ * the list for the 'from' node. Exits on allocation failure.
  */
-static void add_edge_to_list(Edge** adj, int from, int to, double weight) {
-    Edge* e = (Edge*)malloc(sizeof(Edge));
+static void add_edge_to_list(Graph* g, Edge** adj, int from, int to, double weight) {
+    Edge* e = (Edge*)mem_new_object(&g->mem, sizeof(Edge));
     if (!e) {
         fprintf(stderr, "Error: failed to allocate edge.\n");
         exit(EXIT_FAILURE);
@@ -38,10 +38,11 @@ Graph* create_graph(int num_nodes) {
 
     g->num_nodes = num_nodes;
     g->num_edges = 0;
+    mem_init(&g->mem);
     
     // Use calloc to initialize all pointers in the adjacency lists to NULL
-    g->adj = (Edge**)calloc(num_nodes, sizeof(Edge*));
-    g->rev_adj = (Edge**)calloc(num_nodes, sizeof(Edge*));
+    g->adj = (Edge**)mem_calloc(&g->mem, num_nodes, sizeof(Edge*));
+    g->rev_adj = (Edge**)mem_calloc(&g->mem, num_nodes, sizeof(Edge*));
 
     if (!g->adj || !g->rev_adj) {
         fprintf(stderr, "Error: failed to allocate adjacency lists.\n");
@@ -65,10 +66,54 @@ void add_edge(Graph* g, int u, int v, double weight) {
     if (u < 0 || v < 0 || u >= g->num_nodes || v >= g->num_nodes)
         return; // Safety check
 
-    add_edge_to_list(g->adj, u, v, weight);
+    add_edge_to_list(g, g->adj, u, v, weight);
     g->num_edges++;
 }
 
+/**
+ * Adds a directed arc (u -> v) the way the DIMACS loader does:
+ * to the forward list of u and to the reverse list of v.
+ */
+void add_arc(Graph* g, int u, int v, double weight) {
+    if (u < 0 || v < 0 || u >= g->num_nodes || v >= g->num_nodes)
+        return; // Safety check
+
+    add_edge_to_list(g, g->adj, u, v, weight);
+    add_edge_to_list(g, g->rev_adj, v, u, weight);
+    g->num_edges++;
+}
+
+/**
+ * Updates the weight of an existing arc (u -> v).
+ *
+ * The DIMACS loader stores every arc twice (once in adj[u], once in
+ * rev_adj[v]), so both copies are rewritten. If parallel arcs exist,
+ * only the first one found in each list is changed.
+ */
+int update_edge_weight(Graph* g, int u, int v, double weight) {
+    if (u < 0 || v < 0 || u >= g->num_nodes || v >= g->num_nodes)
+        return 0; // Safety check
+
+    int found = 0;
+    for (Edge* e = g->adj[u]; e; e = e->next) {
+        if (e->to == v) {
+            e->weight = weight;
+            found = 1;
+            break;
+        }
+    }
+    if (!found) return 0;
+
+    // Mirror the change in the reverse list (edge v <- u stored at rev_adj[v])
+    for (Edge* r = g->rev_adj[v]; r; r = r->next) {
+        if (r->to == u) {
+            r->weight = weight;
+            break;
+        }
+    }
+    return 1;
+}
+
 /**
  * Frees all memory associated with the graph.
  *
@@ -84,7 +129,7 @@ void free_graph(Graph* g) {
         Edge* e = g->adj[i];
         while (e) {
             Edge* next = e->next;
-            free(e);
+            mem_free_object(&g->mem, e, sizeof(Edge));
             e = next;
         }
         
@@ -92,12 +137,12 @@ void free_graph(Graph* g) {
         Edge* r = g->rev_adj[i];
         while (r) {
             Edge* next = r->next;
-            free(r);
+            mem_free_object(&g->mem, r, sizeof(Edge));
             r = next;
         }
     }
-    free(g->adj);
-    free(g->rev_adj);
+    mem_free(&g->mem, g->adj, g->num_nodes * sizeof(Edge*));
+    mem_free(&g->mem, g->rev_adj, g->num_nodes * sizeof(Edge*));
     free(g);
 }
 
@@ -161,9 +206,9 @@ Graph* load_dimacs_graph(const char* filename) {
 
             if (from >= 0 && from < num_nodes && to >= 0 && to < num_nodes) {
                 // Add the forward edge: from -> to
-                add_edge_to_list(g->adj, from, to, weight);
+                add_edge_to_list(g, g->adj, from, to, weight);
                 // Add the reverse edge: to -> from
-                add_edge_to_list(g->rev_adj, to, from, weight);
+                add_edge_to_list(g, g->rev_adj, to, from, weight);
                 edge_count++;
             }
         }
@@ -185,6 +230,7 @@ Graph* load_dimacs_graph(const char* filename) {
     printf("Finished loading graph: %ld edges read.\n", edge_count);
 #endif
 
+    g->num_edges = edge_count;
     fclose(fp);
     return g;
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifdef __linux__
+#define _GNU_SOURCE       // sched_setaffinity(), CPU_SET
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "harness.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+int harness_pin_cpu(int cpu) {
+#ifdef _WIN32
+    if (cpu < 0 || cpu >= 64 || !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)) {
+        fprintf(stderr, "Warning: cannot pin to CPU %d\n", cpu);
+        return 0;
+    }
+    return 1;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        fprintf(stderr, "Warning: cannot pin to CPU %d\n", cpu);
+        return 0;
+    }
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("Warning: sched_setaffinity");
+        return 0;
+    }
+    return 1;
+#else
+    fprintf(stderr, "Warning: CPU pinning is not supported on this platform (CPU %d)\n", cpu);
+    return 0;
+#endif
+}
+
+void harness_prefault(const Graph *g, int bytes_per_node) {
+#ifdef __GLIBC__
+    // Large blocks would otherwise be mmap'ed and unmapped per query, so
+    // every query would fault its distance array and heap in again
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1); // Never give freed memory back
+#endif
+
+    // Touch the adjacency lists (they were faulted in by loading, but
+    // may have been swapped or compacted since)
+    volatile double sink = 0;
+    for (int u = 0; u < g->num_nodes; u++)
+        for (Edge *e = g->adj[u]; e; e = e->next) sink += e->weight;
+    (void)sink;
+
+    // Grow the heap by one query's working set while pages are cheap to get
+    size_t bytes = (size_t)g->num_nodes * bytes_per_node;
+    char *block = malloc(bytes);
+    if (block) {
+        memset(block, 0, bytes);
+        free(block);
+    }
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double harness_median(double *v, int n) {
+    if (n <= 0) return 0;
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+double harness_mad(const double *v, int n, double median) {
+    if (n <= 0) return 0;
+    double dev[MAX_REPETITIONS];
+    double *d = (n <= MAX_REPETITIONS) ? dev : malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) d[i] = fabs(v[i] - median);
+    double mad = harness_median(d, n);
+    if (d != dev) free(d);
+    return mad;
+}
@@ -0,0 +1,375 @@
+/*
+ * heap_bench: microbenchmarks for the priority queues behind Dijkstra.
+ *
+ * Every heap is driven through the same HeapOps table with synthetic
+ * operation patterns, at sizes 10^min_exp .. 10^max_exp. Each pattern
+ * is repeated on a fresh heap until at least MIN_OPS operations were
+ * timed; heap creation, key setup and freeing are not timed. Reports
+ * nanoseconds per heap operation and, where perf_event_open works,
+ * L1D and last-level cache misses per operation. Without counters the
+ * miss rate is estimated from the heap's peak footprint and the LLC size.
+ *
+ * To benchmark a new heap, add its wrappers and a row to 'heaps'.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+#include "fibheap.h"
+#include "pairingheap.h"
+#include "memtrack.h"
+#include "perfcount.h"
+#include "timer.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#define MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define MKDIR(path) mkdir(path, 0755)
+#endif
+
+// Operations timed per pattern and size at least (rounds are repeated).
+#define MIN_OPS (1L << 22)
+
+// Hold model: extract-min + insert pairs per element after the fill.
+#define HOLDS_PER_ELEMENT 4
+
+// Decrease-key mix: decrease-keys on random live elements per extract-min.
+#define DECREASES_PER_EXTRACT 4
+
+// Dijkstra-like pattern: random "arcs" relaxed per extracted element.
+#define DIJKSTRA_DEGREE 4
+
+// One priority queue implementation behind a common interface.
+typedef struct {
+    const char *name;
+    void* (*create)(int n);
+    void (*insert)(void *h, double key, int id);
+    int (*extract_min)(void *h);                  // -1 if empty
+    void (*decrease_key)(void *h, int id, double key);
+    void (*memory)(void *h, MemCounter *out);
+    void (*free)(void *h);
+} HeapOps;
+
+static void* fib_create_op(int n) { return fib_create(n); }
+static void fib_insert_op(void *h, double key, int id) { fib_insert(h, key, id); }
+static int fib_extract_op(void *h) { return fib_extract_min(h); }
+static void fib_decrease_op(void *h, int id, double key) { fib_decrease_key(h, id, key); }
+static void fib_memory_op(void *h, MemCounter *out) { fib_memory(h, out); }
+static void fib_free_op(void *h) { fib_free(h); }
+
+static void* pair_create_op(int n) { return pair_create(n); }
+static void pair_insert_op(void *h, double key, int id) { pair_insert(h, key, id); }
+static int pair_extract_op(void *h) { return pair_extract_min(h); }
+static void pair_decrease_op(void *h, int id, double key) { pair_decrease_key(h, id, key); }
+static void pair_memory_op(void *h, MemCounter *out) { pair_memory(h, out); }
+static void pair_free_op(void *h) { pair_free(h); }
+
+static const HeapOps heaps[] = {
+    { "fib", fib_create_op, fib_insert_op, fib_extract_op, fib_decrease_op, fib_memory_op, fib_free_op },
+    { "pair", pair_create_op, pair_insert_op, pair_extract_op, pair_decrease_op, pair_memory_op, pair_free_op },
+};
+#define NUM_HEAPS ((int)(sizeof(heaps) / sizeof(heaps[0])))
+
+// splitmix64 stream.
+typedef struct {
+    unsigned long long s;
+} Rng;
+
+static unsigned long long rng_next(Rng *r) {
+    unsigned long long z = (r->s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, n) for n < 2^32.
+static int rng_below(Rng *r, int n) {
+    return (int)(((rng_next(r) >> 32) * (unsigned long long)n) >> 32);
+}
+
+// Uniform in [0, 1).
+static double rng_uniform(Rng *r) {
+    return (rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+// Per-size arrays shared by the patterns (not timed).
+typedef struct {
+    double *key;          // Current key of each id
+    int *live;            // Ids in the heap (decrease mix) or state (Dijkstra)
+    int *pos;             // Position of each id in 'live'
+} Scratch;
+
+/*
+ * A pattern sets up 'sc' (untimed), then runs on an empty heap of
+ * capacity n and returns the number of heap operations it performed.
+ */
+typedef struct {
+    const char *name;
+    void (*prepare)(Scratch *sc, int n, Rng *rng);
+    long (*run)(const HeapOps *op, void *h, int n, Scratch *sc, Rng *rng);
+} Pattern;
+
+static void prepare_sorted(Scratch *sc, int n, Rng *rng) {
+    (void)rng;
+    for (int i = 0; i < n; i++) sc->key[i] = i;
+}
+
+static void prepare_reverse(Scratch *sc, int n, Rng *rng) {
+    (void)rng;
+    for (int i = 0; i < n; i++) sc->key[i] = n - i;
+}
+
+static void prepare_random(Scratch *sc, int n, Rng *rng) {
+    for (int i = 0; i < n; i++) sc->key[i] = rng_uniform(rng);
+}
+
+// Inserts ids 0..n-1 with their keys in id order, then extracts them all.
+static long run_insert_drain(const HeapOps *op, void *h, int n, Scratch *sc, Rng *rng) {
+    (void)rng;
+    for (int i = 0; i < n; i++) op->insert(h, sc->key[i], i);
+    while (op->extract_min(h) >= 0) ;
+    return 2L * n + 1; // The final extract finds the heap empty
+}
+
+/*
+ * Hold model: fill with n random keys, then repeatedly extract the
+ * minimum and reinsert it with its key increased by a uniform amount,
+ * which keeps the size at n while keys drift upward.
+ */
+static long run_hold(const HeapOps *op, void *h, int n, Scratch *sc, Rng *rng) {
+    for (int i = 0; i < n; i++) op->insert(h, sc->key[i], i);
+    long holds = (long)HOLDS_PER_ELEMENT * n;
+    for (long k = 0; k < holds; k++) {
+        int id = op->extract_min(h);
+        sc->key[id] += rng_uniform(rng);
+        op->insert(h, sc->key[id], id);
+    }
+    return n + 2 * holds;
+}
+
+/*
+ * Decrease-key mix: fill with n random keys, then until the heap is
+ * empty lower the keys of DECREASES_PER_EXTRACT random elements still
+ * in the heap before each extract-min.
+ */
+static long run_decrease_mix(const HeapOps *op, void *h, int n, Scratch *sc, Rng *rng) {
+    for (int i = 0; i < n; i++) {
+        op->insert(h, sc->key[i], i);
+        sc->live[i] = i;
+        sc->pos[i] = i;
+    }
+    long ops = n;
+    for (int count = n; count > 0; count--) {
+        for (int d = 0; d < DECREASES_PER_EXTRACT; d++) {
+            int id = sc->live[rng_below(rng, count)];
+            sc->key[id] *= 1.0 - 0.5 * rng_uniform(rng);
+            op->decrease_key(h, id, sc->key[id]);
+        }
+        int id = op->extract_min(h);
+        int last = sc->live[count - 1]; // Swap-remove id from the live set
+        sc->live[sc->pos[id]] = last;
+        sc->pos[last] = sc->pos[id];
+        ops += DECREASES_PER_EXTRACT + 1;
+    }
+    return ops;
+}
+
+static void prepare_dijkstra(Scratch *sc, int n, Rng *rng) {
+    (void)rng;
+    for (int i = 0; i < n; i++) {
+        sc->key[i] = DBL_MAX;
+        sc->live[i] = 0; // 0 = unseen, 1 = in heap, 2 = settled
+    }
+}
+
+/*
+ * Dijkstra-like monotone keys: starting from id 0, every extracted id
+ * "relaxes" DIJKSTRA_DEGREE random ids with key + a weight in [1, 100),
+ * inserting unseen ids and decreasing keys that improve, as a search on
+ * a random graph would.
+ */
+static long run_dijkstra(const HeapOps *op, void *h, int n, Scratch *sc, Rng *rng) {
+    int *state = sc->live;
+    sc->key[0] = 0;
+    state[0] = 1;
+    op->insert(h, 0, 0);
+    long ops = 1;
+    int u;
+    while ((u = op->extract_min(h)) >= 0) {
+        ops++;
+        state[u] = 2;
+        for (int d = 0; d < DIJKSTRA_DEGREE; d++) {
+            int v = rng_below(rng, n);
+            if (state[v] == 2) continue;
+            double nd = sc->key[u] + 1 + 99 * rng_uniform(rng);
+            if (state[v] == 0) {
+                sc->key[v] = nd;
+                state[v] = 1;
+                op->insert(h, nd, v);
+                ops++;
+            } else if (nd < sc->key[v]) {
+                sc->key[v] = nd;
+                op->decrease_key(h, v, nd);
+                ops++;
+            }
+        }
+    }
+    return ops + 1; // The final extract finds the heap empty
+}
+
+static const Pattern patterns[] = {
+    { "sorted", prepare_sorted, run_insert_drain },
+    { "reverse", prepare_reverse, run_insert_drain },
+    { "random", prepare_random, run_insert_drain },
+    { "hold", prepare_random, run_hold },
+    { "decrease", prepare_random, run_decrease_mix },
+    { "dijkstra", prepare_dijkstra, run_dijkstra },
+};
+#define NUM_PATTERNS ((int)(sizeof(patterns) / sizeof(patterns[0])))
+
+// Returns 1 if 'name' is in the comma-separated 'list' or 'list' is "all".
+static int selected(const char *list, const char *name) {
+    if (strcmp(list, "all") == 0) return 1;
+    size_t len = strlen(name);
+    for (const char *p = list; *p; ) {
+        size_t flen = strcspn(p, ",");
+        if (flen == len && strncmp(p, name, len) == 0) return 1;
+        p += flen;
+        if (*p == ',') p++;
+    }
+    return 0;
+}
+
+// Size of the last-level cache in bytes, or 0 if unknown.
+static long llc_bytes(void) {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l3 > 0) return l3;
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l2 > 0) return l2;
+#endif
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
+        printf("Usage: %s [heaps=all] [patterns=all] [min_exp=3] [max_exp=7] [seed=1] [csv=result/bench/heap_bench.csv]\n", argv[0]);
+        printf("heaps:");
+        for (int i = 0; i < NUM_HEAPS; i++) printf(" %s", heaps[i].name);
+        printf("\npatterns:");
+        for (int i = 0; i < NUM_PATTERNS; i++) printf(" %s", patterns[i].name);
+        printf("\nLists are comma-separated, e.g. %s fib,pair hold,dijkstra 3 6\n", argv[0]);
+        return 0;
+    }
+    const char *heap_list = (argc >= 2) ? argv[1] : "all";
+    const char *pattern_list = (argc >= 3) ? argv[2] : "all";
+    int min_exp = (argc >= 4) ? atoi(argv[3]) : 3;
+    int max_exp = (argc >= 5) ? atoi(argv[4]) : 7;
+    unsigned long long seed = (argc >= 6) ? strtoull(argv[5], NULL, 10) : 1;
+    // Not in result/ itself, where compare_runs looks for run logs
+    const char *csv_path = (argc >= 7) ? argv[6] : "result/bench/heap_bench.csv";
+    if (min_exp < 1) min_exp = 1;
+    if (max_exp > 8) max_exp = 8;
+
+    MKDIR("result");
+    MKDIR("result/bench");
+    PerfGroup *perf = perf_open();
+    long llc = llc_bytes();
+    FILE *fcsv = fopen(csv_path, "w");
+    if (!fcsv) fprintf(stderr, "Warning: cannot write %s\n", csv_path);
+    else fprintf(fcsv, "heap,pattern,n,rounds,ops,ns_per_op,l1d_miss_per_op,llc_miss_per_op,"
+                       "peak_bytes,est_llc_miss_rate\n");
+
+    printf("%-5s %-9s %10s %7s %12s %9s %9s %9s %10s %8s %8s\n", "Heap", "Pattern", "n", "Rounds", "Ops",
+           "ns/op", "L1D/op", "LLC/op", "Peak(MB)", "B/elem", "EstMiss");
+
+    for (int e = min_exp; e <= max_exp; e++) {
+        int n = (int)pow(10, e);
+        Scratch sc;
+        sc.key = malloc(n * sizeof(double));
+        sc.live = malloc(n * sizeof(int));
+        sc.pos = malloc(n * sizeof(int));
+        if (!sc.key || !sc.live || !sc.pos) {
+            fprintf(stderr, "Cannot allocate scratch arrays for n = %d\n", n);
+            free(sc.key);
+            free(sc.live);
+            free(sc.pos);
+            break;
+        }
+
+        for (int p = 0; p < NUM_PATTERNS; p++) {
+            if (!selected(pattern_list, patterns[p].name)) continue;
+            for (int k = 0; k < NUM_HEAPS; k++) {
+                const HeapOps *op = &heaps[k];
+                if (!selected(heap_list, op->name)) continue;
+
+                // Same keys and choices for every heap
+                Rng rng = { seed ^ ((unsigned long long)e << 32) ^ (unsigned long long)p };
+                double time = 0;
+                long ops = 0;
+                long long peak = 0;
+                int rounds = 0;
+                uint64_t misses[PERF_NUM_EVENTS] = { 0 };
+                while (ops < MIN_OPS) {
+                    patterns[p].prepare(&sc, n, &rng);
+                    void *h = op->create(n);
+                    uint64_t counts[PERF_NUM_EVENTS];
+                    if (perf) perf_start(perf);
+                    double t0 = timer_now();
+                    ops += patterns[p].run(op, h, n, &sc, &rng);
+                    time += timer_now() - t0;
+                    if (perf) {
+                        perf_stop(perf, counts);
+                        for (int c = 0; c < PERF_NUM_EVENTS; c++)
+                            misses[c] = (counts[c] == UINT64_MAX || misses[c] == UINT64_MAX)
+                                        ? UINT64_MAX : misses[c] + counts[c];
+                    }
+                    MemCounter mem;
+                    op->memory(h, &mem);
+                    if (mem.peak > peak) peak = mem.peak;
+                    op->free(h);
+                    rounds++;
+                }
+
+                double ns = 1e9 * time / ops;
+                int have_l1 = perf && misses[PERF_L1D_MISSES] != UINT64_MAX;
+                int have_llc = perf && misses[PERF_LLC_MISSES] != UINT64_MAX;
+                double l1 = have_l1 ? (double)misses[PERF_L1D_MISSES] / ops : -1;
+                double llc_op = have_llc ? (double)misses[PERF_LLC_MISSES] / ops : -1;
+                // Chance that a random access into the heap misses the LLC
+                double est = (llc > 0 && peak > llc) ? 1.0 - (double)llc / peak : 0;
+
+                printf("%-5s %-9s %10d %7d %12ld %9.2f ", op->name, patterns[p].name, n, rounds, ops, ns);
+                if (have_l1) printf("%9.3f ", l1);
+                else printf("%9s ", "-");
+                if (have_llc) printf("%9.3f ", llc_op);
+                else printf("%9s ", "-");
+                printf("%10.2f %8.1f %8.3f\n", peak / 1048576.0, (double)peak / n, est);
+                fflush(stdout);
+                if (fcsv)
+                    fprintf(fcsv, "%s,%s,%d,%d,%ld,%.3f,%.4f,%.4f,%lld,%.4f\n", op->name, patterns[p].name,
+                            n, rounds, ops, ns, l1, llc_op, peak, est);
+            }
+        }
+        free(sc.key);
+        free(sc.live);
+        free(sc.pos);
+    }
+
+    if (llc > 0)
+        printf("\nEstMiss: chance a random heap access misses the LLC, 1 - LLC/peak bytes (LLC %ld KB)\n",
+               llc / 1024);
+    else
+        printf("\nEstMiss: unknown LLC size, reported as 0\n");
+    if (fcsv) {
+        fclose(fcsv);
+        printf("Results written to %s\n", csv_path);
+    }
+    perf_close(perf);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "interleave.h"
+#include "memtrack.h"
+#include "timer.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
+// A binary heap entry (lazy deletion: stale entries are skipped on pop).
+typedef struct {
+    double key;
+    int node;
+} SlotItem;
+
+// The state of one in-flight query.
+typedef struct {
+    int query;            // Query index, -1 if the slot is idle
+    int s, t;
+    double start;         // timer_now() when the query was loaded
+    int settled;
+
+    double *dist;         // DBL_MAX outside the current search
+    int *touched;         // Nodes whose dist must be reset
+    int num_touched;
+
+    SlotItem *heap;       // 1-based binary heap
+    int heap_size;
+    int heap_cap;
+} QuerySlot;
+
+static void slot_push(QuerySlot *q, double key, int node) {
+    if (q->heap_size + 1 > q->heap_cap) {
+        q->heap_cap *= 2;
+        q->heap = xrealloc(q->heap, (q->heap_cap + 1) * sizeof(SlotItem));
+    }
+    int i = ++q->heap_size;
+    while (i > 1 && q->heap[i / 2].key > key) {
+        q->heap[i] = q->heap[i / 2];
+        i /= 2;
+    }
+    q->heap[i].key = key;
+    q->heap[i].node = node;
+}
+
+static SlotItem slot_pop(QuerySlot *q) {
+    SlotItem top = q->heap[1];
+    SlotItem last = q->heap[q->heap_size--];
+    int i = 1, c = 2;
+    while (c <= q->heap_size) {
+        if (c + 1 <= q->heap_size && q->heap[c + 1].key < q->heap[c].key) c++;
+        if (last.key <= q->heap[c].key) break;
+        q->heap[i] = q->heap[c];
+        i = c;
+        c = 2 * i;
+    }
+    q->heap[i] = last;
+    return top;
+}
+
+static void slot_relax(QuerySlot *q, int v, double nd) {
+    if (nd >= q->dist[v]) return;
+    if (q->dist[v] == DBL_MAX) q->touched[q->num_touched++] = v;
+    q->dist[v] = nd;
+    slot_push(q, nd, v);
+}
+
+// Resets the slot and starts query 'qi' in it.
+static void slot_load(QuerySlot *q, const Graph *g, const int *queries, int qi) {
+    for (int i = 0; i < q->num_touched; i++) q->dist[q->touched[i]] = DBL_MAX;
+    q->num_touched = 0;
+    q->heap_size = 0;
+
+    q->query = qi;
+    q->s = queries[qi * 2];
+    q->t = queries[qi * 2 + 1];
+    q->settled = 0;
+    q->start = timer_now();
+    if (q->s >= 0 && q->s < g->num_nodes && q->t >= 0 && q->t < g->num_nodes)
+        slot_relax(q, q->s, 0.0);
+}
+
+/**
+ * Settles one node of the slot's search.
+ * Returns 1 when the query is finished (t settled or heap empty).
+ */
+static int slot_step(QuerySlot *q, const Graph *g) {
+    while (q->heap_size > 0) {
+        SlotItem it = slot_pop(q);
+        int u = it.node;
+        if (it.key > q->dist[u]) continue; // Stale entry
+
+        q->settled++;
+        if (u == q->t) return 1;
+        for (Edge *e = g->adj[u]; e; e = e->next)
+            slot_relax(q, e->to, it.key + e->weight);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Prefetches for a slot that runs 'ahead' turns from now: two turns
+ * ahead the adjacency slot and dist entry of its heap top, one turn
+ * ahead (when that pointer is cached) the top's first arc.
+ */
+static void slot_prefetch(const QuerySlot *q, const Graph *g, int ahead) {
+    if (q->query < 0 || q->heap_size == 0) return;
+    int u = q->heap[1].node;
+    if (ahead >= 2) {
+        PREFETCH(&g->adj[u]);
+        PREFETCH(&q->dist[u]);
+    } else {
+        PREFETCH(g->adj[u]);
+        PREFETCH(&q->heap[2]);
+    }
+}
+
+void run_interleaved(const Graph *g, const int *queries, int n, int width, InterleaveResult *results) {
+    int nn = g->num_nodes;
+    if (width < 1) width = 1;
+    if (width > n) width = n;
+    if (n <= 0) return;
+
+    QuerySlot *slots = xmalloc(width * sizeof(QuerySlot));
+    for (int w = 0; w < width; w++) {
+        QuerySlot *q = &slots[w];
+        q->dist = xmalloc(nn * sizeof(double));
+        for (int i = 0; i < nn; i++) q->dist[i] = DBL_MAX;
+        q->touched = xmalloc(nn * sizeof(int));
+        q->num_touched = 0;
+        q->heap_cap = 1024;
+        q->heap = xmalloc((q->heap_cap + 1) * sizeof(SlotItem));
+        q->heap_size = 0;
+        q->query = -1;
+    }
+
+    int next = 0, active = 0;
+    for (int w = 0; w < width; w++) {
+        slot_load(&slots[w], g, queries, next++);
+        active++;
+    }
+
+    for (int w = 0; active > 0; w = (w + 1 == width) ? 0 : w + 1) {
+        QuerySlot *q = &slots[w];
+        if (q->query < 0) continue;
+
+        if (width > 1) {
+            slot_prefetch(&slots[(w + 1) % width], g, 1);
+            slot_prefetch(&slots[(w + 2) % width], g, 2);
+        }
+
+        if (!slot_step(q, g)) continue;
+
+        InterleaveResult *r = &results[q->query];
+        r->dist = (q->t >= 0 && q->t < nn) ? q->dist[q->t] : DBL_MAX;
+        r->settled = q->settled;
+        r->latency = timer_now() - q->start;
+
+        if (next < n) {
+            slot_load(q, g, queries, next++);
+        } else {
+            q->query = -1;
+            active--;
+        }
+    }
+
+    for (int w = 0; w < width; w++) {
+        free(slots[w].dist);
+        free(slots[w].touched);
+        free(slots[w].heap);
+    }
+    free(slots);
+}
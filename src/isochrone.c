@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "isochrone.h"
+#include "memtrack.h"
+
+RangeSearch* range_create(const Graph *g, const char *heap_type) {
+    int use_pair;
+    if (strcmp(heap_type, "fib") == 0) use_pair = 0;
+    else if (strcmp(heap_type, "pair") == 0) use_pair = 1;
+    else return NULL;
+
+    int n = g->num_nodes;
+    RangeSearch *r = xmalloc(sizeof(RangeSearch));
+    r->g = g;
+    r->fib = use_pair ? NULL : fib_create(n);
+    r->pair = use_pair ? pair_create(n) : NULL;
+    if (!r->fib && !r->pair) {
+        fprintf(stderr, "Error: isochrone heap allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    r->dist = xmalloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) r->dist[i] = DBL_MAX;
+    r->touched = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    r->num_touched = 0;
+    r->nodes = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    r->num_nodes = 0;
+    r->boundary_cap = 1024;
+    r->boundary = xmalloc(r->boundary_cap * sizeof(BoundaryArc));
+    r->num_boundary = 0;
+    return r;
+}
+
+static void add_boundary(RangeSearch *r, int u, const Edge *e, double remaining) {
+    if (r->num_boundary == r->boundary_cap) {
+        r->boundary_cap *= 2;
+        r->boundary = xrealloc(r->boundary, r->boundary_cap * sizeof(BoundaryArc));
+    }
+    BoundaryArc *b = &r->boundary[r->num_boundary++];
+    b->from = u;
+    b->to = e->to;
+    b->weight = e->weight;
+    b->remaining = remaining;
+}
+
+int range_query(RangeSearch *r, int s, double budget, int with_boundary) {
+    const Graph *g = r->g;
+    double *dist = r->dist;
+
+    // Reset the labels of the previous query
+    for (int i = 0; i < r->num_touched; i++) dist[r->touched[i]] = DBL_MAX;
+    r->num_touched = 0;
+    r->num_nodes = 0;
+    r->num_boundary = 0;
+    if (s < 0 || s >= g->num_nodes || budget < 0) return 0;
+
+    dist[s] = 0.0;
+    r->touched[r->num_touched++] = s;
+    if (r->fib) fib_insert(r->fib, 0.0, s);
+    else pair_insert(r->pair, 0.0, s);
+
+    while (1) {
+        int u = r->fib ? fib_extract_min(r->fib) : pair_extract_min(r->pair);
+        if (u == -1) break;
+        // The minimum is out of range, and so is everything still queued
+        if (dist[u] > budget) break;
+        r->nodes[r->num_nodes++] = u;
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            int v = e->to;
+            double nd = dist[u] + e->weight;
+            if (nd < dist[v]) {
+                if (dist[v] == DBL_MAX) r->touched[r->num_touched++] = v;
+                dist[v] = nd;
+                if (r->fib) fib_decrease_key(r->fib, v, nd);
+                else pair_decrease_key(r->pair, v, nd);
+            }
+        }
+    }
+
+    // Drop the frontier still in the heap (cost proportional to its size)
+    if (r->fib) fib_clear(r->fib);
+    else pair_clear(r->pair);
+
+    if (with_boundary) {
+        for (int i = 0; i < r->num_nodes; i++) {
+            int u = r->nodes[i];
+            double remaining = budget - dist[u];
+            for (Edge *e = g->adj[u]; e; e = e->next) {
+                if (e->weight > remaining) add_boundary(r, u, e, remaining);
+            }
+        }
+    }
+    return r->num_nodes;
+}
+
+void range_free(RangeSearch *r) {
+    if (!r) return;
+    if (r->fib) fib_free(r->fib);
+    if (r->pair) pair_free(r->pair);
+    free(r->dist);
+    free(r->touched);
+    free(r->nodes);
+    free(r->boundary);
+    free(r);
+}
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "latency.h"
+#include "memtrack.h"
+
+static const char *phase_names[NUM_PHASES + 1] = {
+    "alloc", "dist init", "heap create", "search", "teardown", "total"
+};
+
+LatencyRecorder* latency_create(int capacity) {
+    if (capacity < 16) capacity = 16;
+    LatencyRecorder *r = xmalloc(sizeof(LatencyRecorder));
+    r->count = 0;
+    r->capacity = capacity;
+    for (int p = 0; p <= NUM_PHASES; p++) r->samples[p] = xmalloc(capacity * sizeof(double));
+    return r;
+}
+
+void latency_add(LatencyRecorder *r, const double *phase) {
+    if (r->count == r->capacity) {
+        r->capacity *= 2;
+        for (int p = 0; p <= NUM_PHASES; p++) {
+            r->samples[p] = xrealloc(r->samples[p], r->capacity * sizeof(double));
+        }
+    }
+    double total = 0;
+    for (int p = 0; p < NUM_PHASES; p++) {
+        r->samples[p][r->count] = phase[p];
+        total += phase[p];
+    }
+    r->samples[NUM_PHASES][r->count] = total;
+    r->count++;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double latency_percentile(double *values, int n, double p) {
+    if (n <= 0) return 0;
+    qsort(values, n, sizeof(double), cmp_double);
+    int rank = (int)ceil(p / 100.0 * n);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return values[rank - 1];
+}
+
+void latency_print(LatencyRecorder *r, double wall_time) {
+    int n = r->count;
+    if (n == 0) return;
+
+    printf("%-12s %12s %12s %12s %12s %12s\n", "Phase (us)", "mean", "p50", "p90", "p99", "max");
+    for (int p = 0; p <= NUM_PHASES; p++) {
+        double *v = r->samples[p];
+        double sum = 0;
+        for (int i = 0; i < n; i++) sum += v[i];
+        // Sorting is idempotent, so the later calls only re-check order
+        double p50 = latency_percentile(v, n, 50);
+        double p90 = latency_percentile(v, n, 90);
+        double p99 = latency_percentile(v, n, 99);
+        printf("%-12s %12.2f %12.2f %12.2f %12.2f %12.2f\n", phase_names[p],
+               1e6 * sum / n, 1e6 * p50, 1e6 * p90, 1e6 * p99, 1e6 * v[n - 1]);
+    }
+    printf("Throughput: %.2f queries/sec (%d queries in %.6f sec wall)\n",
+           wall_time > 0 ? n / wall_time : 0.0, n, wall_time);
+}
+
+void latency_free(LatencyRecorder *r) {
+    if (!r) return;
+    for (int p = 0; p <= NUM_PHASES; p++) free(r->samples[p]);
+    free(r);
+}
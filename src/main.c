@@ -3,6 +3,8 @@
 #include <string.h>
 #include <time.h>
 #include <float.h>
+#include <math.h>
+#include <stdint.h>
 #include <sys/stat.h>
 
 // Platform-specific includes for directory handling
@@ -16,8 +18,103 @@
 #define MKDIR(path) mkdir(path, 0755)
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "graph.h"
 #include "dijkstra.h"
+#include "timer.h"
+#include "crp.h"
+#include "arcflags.h"
+#include "deltastep.h"
+#include "batch.h"
+#include "planner.h"
+#include "multisource.h"
+#include "interleave.h"
+#include "scc.h"
+#include "contract.h"
+#include "approx.h"
+#include "isochrone.h"
+#include "dynsssp.h"
+#include "latency.h"
+#include "perfcount.h"
+#include "runlog.h"
+#include "harness.h"
+#include "memtrack.h"
+#include "synthgraph.h"
+
+// Number of CRP queries cross-checked against plain Dijkstra.
+#define CRP_VERIFY_QUERIES 100
+
+// Settings for the "delta" algorithm (parallel delta-stepping).
+// 0 means "use the default" (OMP_NUM_THREADS / average arc weight).
+static int delta_threads = 0;
+static double delta_width = 0;
+
+// Reachability index for the query-file modes (NULL = always search).
+static SccIndex *scc_index = NULL;
+
+// Graph file of this run, recorded in the run logs.
+static const char *graph_path = "";
+
+// Set when the graph comes from a synthetic spec ("grid:1e6") rather
+// than a file, so nothing is cached next to it.
+static int graph_is_synthetic = 0;
+
+// Counters per query in HEAP_STATS builds (see heap_stats_names).
+#define NUM_HEAP_STATS 10
+
+#ifdef HEAP_STATS
+// Heap counters of the last run_single_query ("fib" and "pair" only).
+static HeapStats query_heap_stats;
+#endif
+
+// Allocations of the last run_single_query ("fib" and "pair" only): the
+// distance array in query_mem, the heap's own counters in query_heap_mem.
+static MemCounter query_mem;
+static MemCounter query_heap_mem;
+
+// Memory columns of the run logs (-1 for heaps that are not counted).
+#define NUM_MEM_COUNTERS 3
+static const char *mem_counter_names[NUM_MEM_COUNTERS] = {
+    "peak_bytes", "heap_peak_bytes", "heap_peak_nodes"
+};
+
+// Hardware counters around each query of the query-file modes (NULL = off).
+static PerfGroup *perf_group = NULL;
+
+// Per-query limits for the query-file modes (0 = no limit).
+// Only "fib" and "pair" honour them; "delta" always runs to completion.
+static double query_timeout = 10.0;
+static long query_max_settled = 0;
+
+// Stop "fib" and "pair" searches once 't' is settled instead of running a
+// full SSSP. Set for rank-tagged query files, where query size matters.
+static int query_stop_at_target = 0;
+
+// Harness settings for the query-file and alternate modes: untimed runs
+// before each query, then timed runs whose median is reported.
+static int query_warmup = 0;
+static int query_reps = 1;
+
+// Bytes one "fib"/"pair" query allocates per node (distance array, heap
+// node map, heap node), pre-faulted by harness_prefault.
+#define QUERY_BYTES_PER_NODE 80
+
+/**
+ * Runs a full SSSP from 's' with the selected algorithm.
+ * Returns a new distance array, or NULL for an unknown heap type.
+ */
+static double* run_sssp(const Graph *g, int s, const char *heap_type) {
+    if (strcmp(heap_type, "fib") == 0)
+        return dijkstra_fibheap(g, s);
+    if (strcmp(heap_type, "pair") == 0)
+        return dijkstra_pairingheap(g, s);
+    if (strcmp(heap_type, "delta") == 0)
+        return dijkstra_delta(g, s, delta_width, delta_threads);
+    return NULL;
+}
 
 // Simple cross-platform check for file existence.
 int file_exists(const char *path) {
@@ -36,112 +133,783 @@ int is_directory(const char *path) {
 /**
  * Loads (source, target) query pairs from a file.
  *
- * Reads pairs of integers from 'filename' and stores them in a
- * dynamically allocated array pointed to by 'queries'.
+ * Reads one "s t [tag]" line per query from 'filename' and stores the
+ * pairs in a dynamically allocated array pointed to by 'queries'.
  * Converts the 1-based node indices from the file to 0-based.
+ * Lines without two integers (headers, comments) are skipped.
+ * If 'tags' is not NULL it receives an array with the optional third
+ * column of each line (e.g. the Dijkstra rank exponent), -1 where absent.
  *
  * Returns the total number of query pairs loaded.
  */
-int load_query_pairs(const char *filename, int **queries) {
+int load_query_file(const char *filename, int **queries, int **tags) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return 0;
 
-    int s, t;
+    char line[256];
+    int s, t, tag;
     int count = 0;
     int cap = 1024;
     *queries = malloc(cap * 2 * sizeof(int));
+    if (tags) *tags = malloc(cap * sizeof(int));
 
-    while (fscanf(fp, "%d %d", &s, &t) == 2) {
+    while (fgets(line, sizeof(line), fp)) {
+        int fields = sscanf(line, "%d %d %d", &s, &t, &tag);
+        if (fields < 2) continue;
         if (count >= cap) {
             // Resize the array if more capacity is needed
             cap *= 2;
             *queries = realloc(*queries, cap * 2 * sizeof(int));
+            if (tags) *tags = realloc(*tags, cap * sizeof(int));
         }
         // Convert from 1-based (file) to 0-based (internal)
         (*queries)[count * 2] = s - 1;
         (*queries)[count * 2 + 1] = t - 1;
+        if (tags) (*tags)[count] = (fields == 3) ? tag : -1;
         count++;
     }
     fclose(fp);
     return count;
 }
 
+// Loads query pairs only, ignoring any tag column (see load_query_file).
+int load_query_pairs(const char *filename, int **queries) {
+    return load_query_file(filename, queries, NULL);
+}
+
 /**
  * Runs a single-source Dijkstra from 's' and returns the distance to 't'.
  * This function times the *entire* operation, including heap creation,
  * Dijkstra's algorithm, and distance array cleanup.
+ * If the SCC index is loaded, pairs it proves unreachable return at once.
+ * "fib" and "pair" searches stop once query_timeout seconds have passed
+ * or query_max_settled nodes have been settled, and at 't' if
+ * query_stop_at_target is set.
  *
  * Returns the shortest distance, or DBL_MAX if unreachable.
  * The time taken is stored in the 'time_used' output parameter.
+ * If 'timed_out' is not NULL it is set to 1 when the search was aborted
+ * (the result is then DBL_MAX, not a distance), 0 otherwise.
+ * If 'phase' is not NULL it receives the time of each QueryPhase; "delta"
+ * cannot be split and reports everything as search time.
  */
-double run_single_query(const Graph *g, int s, int t, const char *heap_type, double *time_used) {
-    clock_t st = clock();
+double run_single_query(const Graph *g, int s, int t, const char *heap_type,
+                        double *time_used, int *timed_out, double *phase) {
+    // Wall-clock time: clock() would add up CPU time over all threads of "delta"
+    double st = timer_now();
     double result = DBL_MAX;
-    
-    if (strcmp(heap_type, "fib") == 0) {
-        // Run Dijkstra with Fibonacci heap
-        double *dist = dijkstra_fibheap(g, s);
-        result = dist[t];
-        free(dist); // Free the distances after lookup
-    } else if (strcmp(heap_type, "pair") == 0) {
-        // Run Dijkstra with Pairing heap
-        double *dist = dijkstra_pairingheap(g, s);
-        result = dist[t];
-        free(dist); // Free the distances after lookup
+    double local[NUM_PHASES];
+    if (!phase) phase = local;
+    for (int p = 0; p < NUM_PHASES; p++) phase[p] = 0;
+    if (timed_out) *timed_out = 0;
+#ifdef HEAP_STATS
+    memset(&query_heap_stats, 0, sizeof(HeapStats));
+#endif
+    mem_init(&query_mem);
+    mem_init(&query_heap_mem);
+
+    // Pairs the SCC index proves unreachable need no search at all
+    if (scc_index && scc_query(scc_index, s, t) == SCC_UNREACHABLE) {
+        *time_used = timer_now() - st;
+        phase[PHASE_SEARCH] = *time_used;
+        return result;
+    }
+
+    int use_fib = strcmp(heap_type, "fib") == 0;
+    if (use_fib || strcmp(heap_type, "pair") == 0) {
+        SearchBudget budget;
+        budget.deadline = (query_timeout > 0) ? st + query_timeout : 0;
+        budget.max_settled = query_max_settled;
+        int n = g->num_nodes;
+
+        double t0 = timer_now();
+        double *dist = mem_malloc(&query_mem, n * sizeof(double));
+        double t1 = timer_now();
+        for (int i = 0; i < n; i++) dist[i] = DBL_MAX;
+        double t2 = timer_now();
+        FibHeap *fh = use_fib ? fib_create(n) : NULL;
+        PairingHeap *ph = use_fib ? NULL : pair_create(n);
+        double t3 = timer_now();
+        int target = query_stop_at_target ? t : -1;
+        int done = use_fib ? dijkstra_fib_budget(g, s, target, dist, fh, &budget)
+                           : dijkstra_pair_budget(g, s, target, dist, ph, &budget);
+        double t4 = timer_now();
+#ifdef HEAP_STATS
+        if (fh) fib_take_stats(fh, &query_heap_stats);
+        else pair_take_stats(ph, &query_heap_stats);
+#endif
+        if (fh) fib_memory(fh, &query_heap_mem);
+        else pair_memory(ph, &query_heap_mem);
+        if (done) result = dist[t];
+        else if (timed_out) *timed_out = 1;
+        if (fh) fib_free(fh);
+        if (ph) pair_free(ph);
+        mem_free(&query_mem, dist, n * sizeof(double));
+        double t5 = timer_now();
+
+        phase[PHASE_ALLOC] = t1 - t0;
+        phase[PHASE_INIT] = t2 - t1;
+        phase[PHASE_HEAP_CREATE] = t3 - t2;
+        phase[PHASE_SEARCH] = t4 - t3;
+        phase[PHASE_TEARDOWN] = t5 - t4;
+    } else {
+        double *dist = run_sssp(g, s, heap_type);
+        if (dist) {
+            result = dist[t];
+            free(dist); // Free the distances after lookup
+        }
+        phase[PHASE_SEARCH] = timer_now() - st;
     }
     
-    clock_t ed = clock();
-    *time_used = (double)(ed - st) / CLOCKS_PER_SEC;
+    *time_used = timer_now() - st;
     return result;
 }
 
+#ifdef HEAP_STATS
+// Adds the counters of 's' to 'total'; maxima are combined with max.
+static void heap_stats_add(HeapStats *total, const HeapStats *s) {
+    total->inserts += s->inserts;
+    total->decrease_keys += s->decrease_keys;
+    total->decrease_noops += s->decrease_noops;
+    total->extract_mins += s->extract_mins;
+    total->links += s->links;
+    total->cuts += s->cuts;
+    total->cascading_cuts += s->cascading_cuts;
+    total->root_list_total += s->root_list_total;
+    if (s->root_list_max > total->root_list_max) total->root_list_max = s->root_list_max;
+    if (s->max_degree > total->max_degree) total->max_degree = s->max_degree;
+}
+
+// Counter names in the order of heap_stats_values.
+static const char *heap_stats_names[NUM_HEAP_STATS] = {
+    "inserts", "decrease_keys", "decrease_noops", "extract_mins", "links", "cuts",
+    "cascading_cuts", "root_list_total", "root_list_max", "max_degree"
+};
+
+static void heap_stats_values(const HeapStats *s, long long *out) {
+    long v[NUM_HEAP_STATS] = {
+        s->inserts, s->decrease_keys, s->decrease_noops, s->extract_mins, s->links,
+        s->cuts, s->cascading_cuts, s->root_list_total, s->root_list_max, s->max_degree
+    };
+    for (int i = 0; i < NUM_HEAP_STATS; i++) out[i] = v[i];
+}
+
+static void write_heap_stats(FILE *f, const HeapStats *s) {
+    long long v[NUM_HEAP_STATS];
+    heap_stats_values(s, v);
+    for (int i = 0; i < NUM_HEAP_STATS; i++) fprintf(f, i ? " %lld" : "%lld", v[i]);
+    fprintf(f, "\n");
+}
+
+#endif
+
+/**
+ * Builds the path of a file for extra per-query data next to a result
+ * file: "x_result.txt" -> "x_<kind>.<ext>", anything else ->
+ * "<name>.<kind>.<ext>".
+ */
+static void companion_path(char *path, size_t size, const char *output_file,
+                           const char *kind, const char *ext) {
+    const char *suffix = "_result.txt";
+    size_t len = strlen(output_file), slen = strlen(suffix);
+    if (len >= slen && strcmp(output_file + len - slen, suffix) == 0)
+        snprintf(path, size, "%.*s_%s.%s", (int)(len - slen), output_file, kind, ext);
+    else
+        snprintf(path, size, "%s.%s.%s", output_file, kind, ext);
+}
+
+// Opens the "<kind>.txt" companion file of a result file for writing.
+static FILE* open_companion_file(const char *output_file, const char *kind) {
+    char path[600];
+    companion_path(path, sizeof(path), output_file, kind, "txt");
+    return fopen(path, "w");
+}
+
+/**
+ * Prints the hardware counter totals of a query file run: per-query
+ * averages, IPC and misses per thousand instructions.
+ */
+static void print_perf_summary(const char *heap_type, const uint64_t *total, int n) {
+    printf("Hardware counters (%s, per query):\n", heap_type);
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (total[e] == UINT64_MAX) continue;
+        printf("  %-14s %16.1f", perf_event_name(e), (double)total[e] / n);
+        if (e >= PERF_L1D_MISSES && total[PERF_INSTRUCTIONS] != UINT64_MAX && total[PERF_INSTRUCTIONS] > 0)
+            printf("   (%.3f per 1k instructions)", 1000.0 * total[e] / total[PERF_INSTRUCTIONS]);
+        printf("\n");
+    }
+    if (total[PERF_CYCLES] != UINT64_MAX && total[PERF_INSTRUCTIONS] != UINT64_MAX && total[PERF_CYCLES] > 0)
+        printf("  IPC %.3f\n", (double)total[PERF_INSTRUCTIONS] / total[PERF_CYCLES]);
+}
+
+/**
+ * Prints query times grouped by the tag column of a rank-tagged query
+ * file (tag i = Dijkstra rank 2^i). Untagged queries are left out.
+ */
+static void print_rank_summary(const char *heap_type, const int *tags, const double *times, int n) {
+    int max_tag = -1;
+    for (int i = 0; i < n; i++) if (tags[i] > max_tag) max_tag = tags[i];
+    if (max_tag < 0) return;
+
+    double *bucket = malloc(n * sizeof(double));
+    printf("Time per Dijkstra rank (%s):\n", heap_type);
+    printf("  %-8s %-8s %-14s %-14s %s\n", "Rank", "Queries", "Avg(s)", "p50(s)", "Max(s)");
+    for (int r = 0; r <= max_tag; r++) {
+        int k = 0;
+        double sum = 0;
+        for (int i = 0; i < n; i++) {
+            if (tags[i] != r) continue;
+            bucket[k++] = times[i];
+            sum += times[i];
+        }
+        if (k == 0) continue;
+        double p50 = latency_percentile(bucket, k, 50);
+        printf("  2^%-6d %-8d %-14.6f %-14.6f %.6f\n", r, k, sum / k, p50, bucket[k - 1]);
+    }
+    free(bucket);
+}
+
+/**
+ * Runs one query query_warmup times untimed, then query_reps times,
+ * and returns its distance. '*time_used' receives the median time and
+ * 'phase' and 'counts' (hardware counters, if perf_group is set) the
+ * values of the repetition closest to it. '*mad' receives the median
+ * absolute deviation of the times and '*outliers' the number of
+ * repetitions more than OUTLIER_MADS scaled MADs from the median.
+ * Repeating stops at the first repetition that times out.
+ */
+static double run_measured_query(const Graph *g, int s, int t, const char *heap_type,
+                                 double *time_used, int *timed_out, double *phase,
+                                 uint64_t *counts, double *mad, int *outliers) {
+    double scratch;
+    int warm_out = 0;
+    for (int w = 0; w < query_warmup && !warm_out; w++)
+        run_single_query(g, s, t, heap_type, &scratch, &warm_out, NULL);
+
+    double rep_time[MAX_REPETITIONS];
+    double rep_phase[MAX_REPETITIONS][NUM_PHASES];
+    uint64_t rep_counts[MAX_REPETITIONS][PERF_NUM_EVENTS];
+    double d = DBL_MAX;
+    int reps = 0;
+    *timed_out = 0;
+    while (reps < query_reps && !*timed_out) {
+        if (perf_group) perf_start(perf_group);
+        d = run_single_query(g, s, t, heap_type, &rep_time[reps], timed_out, rep_phase[reps]);
+        if (perf_group) perf_stop(perf_group, rep_counts[reps]);
+        reps++;
+    }
+
+    double sorted[MAX_REPETITIONS];
+    memcpy(sorted, rep_time, reps * sizeof(double));
+    double median = harness_median(sorted, reps);
+    *mad = harness_mad(rep_time, reps, median);
+    *outliers = 0;
+    int pick = reps - 1; // A timed-out query reports its last repetition
+    for (int r = 0; r < reps; r++) {
+        if (*mad > 0 && fabs(rep_time[r] - median) > OUTLIER_MADS * 1.4826 * *mad) (*outliers)++;
+        if (!*timed_out && fabs(rep_time[r] - median) < fabs(rep_time[pick] - median)) pick = r;
+    }
+    *time_used = *timed_out ? rep_time[pick] : median;
+    memcpy(phase, rep_phase[pick], sizeof(rep_phase[pick]));
+    if (perf_group) memcpy(counts, rep_counts[pick], sizeof(rep_counts[pick]));
+    return d;
+}
+
 /**
  * Runs a full test on a query file.
  * Loads all (s, t) pairs from 'query_file', runs run_single_query
  * for each pair, and writes the results to 'output_file'.
+ * Queries aborted by the per-query budget are written as
+ * "s t TIMEOUT time" so they cannot be mistaken for unreachable pairs.
  * Prints a summary of the total time and average time per query.
+ * Built with HEAP_STATS, the heap counters of every query and their
+ * totals also go to a "_heapstats.txt" file next to 'output_file'.
+ * If hardware counters are enabled (perf_group), each query's counts go
+ * to a "_perf.txt" file and their averages to the summary.
+ * For rank-tagged files ("s t i") searches stop at the target and the
+ * time per Dijkstra rank 2^i is reported as well.
+ * Every run is also logged as "x_<heap>.csv" and "x_<heap>.json" with
+ * host, build, phase times and counters, for compare_runs.
+ * With query_reps > 1 each reported time is the median of the
+ * repetitions (see run_measured_query).
+ * The summary also reports memory: the graph's allocations, the peak
+ * live bytes of a query (distance array plus heap), the peak heap size
+ * in nodes, and the process peak RSS while this file ran.
  */
 void run_query_test(const Graph *g, const char *query_file, const char *output_file, const char *heap_type) {
     int *queries = NULL;
-    int n = load_query_pairs(query_file, &queries);
+    int *tags = NULL;
+    int n = load_query_file(query_file, &queries, &tags);
     if (n == 0) {
         fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        free(tags);
         return;
     }
+    double *times = malloc(n * sizeof(double));
+    double *mads = malloc(n * sizeof(double));
+    int outlier_total = 0;
 
     FILE *fout = fopen(output_file, "w");
     if (!fout) {
         free(queries);
+        free(tags);
+        free(times);
+        free(mads);
         return;
     }
 
     double total_time = 0;
     int reachable = 0;
+    int timeouts = 0;
+    LatencyRecorder *lat = latency_create(n);
+#ifdef HEAP_STATS
+    HeapStats heap_total;
+    memset(&heap_total, 0, sizeof(HeapStats));
+    FILE *fstats = open_companion_file(output_file, "heapstats");
+    if (fstats) {
+        fprintf(fstats, "# s t");
+        for (int i = 0; i < NUM_HEAP_STATS; i++) fprintf(fstats, " %s", heap_stats_names[i]);
+        fprintf(fstats, "\n");
+    }
+#endif
+    uint64_t perf_total[PERF_NUM_EVENTS] = { 0 };
+    FILE *fperf = NULL;
+    if (perf_group) {
+        fperf = open_companion_file(output_file, "perf");
+        if (fperf) {
+            fprintf(fperf, "# s t");
+            for (int e = 0; e < PERF_NUM_EVENTS; e++) fprintf(fperf, " %s", perf_event_name(e));
+            fprintf(fperf, "  (-1 = not counted)\n");
+        }
+    }
+    const char *counter_names[PERF_NUM_EVENTS + NUM_HEAP_STATS + NUM_MEM_COUNTERS];
+    int num_counters = 0;
+    if (perf_group)
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) counter_names[num_counters++] = perf_event_name(e);
+#ifdef HEAP_STATS
+    for (int i = 0; i < NUM_HEAP_STATS; i++) counter_names[num_counters++] = heap_stats_names[i];
+#endif
+    for (int i = 0; i < NUM_MEM_COUNTERS; i++) counter_names[num_counters++] = mem_counter_names[i];
+    RunInfo info = { graph_path, g->num_nodes, g->num_edges, query_file, heap_type,
+                     query_timeout, query_max_settled };
+    char csv_path[600], json_path[600];
+    companion_path(csv_path, sizeof(csv_path), output_file, heap_type, "csv");
+    companion_path(json_path, sizeof(json_path), output_file, heap_type, "json");
+    RunLog *runlog = runlog_open(csv_path, json_path, &info, counter_names, num_counters);
+    int logged = runlog != NULL;
+
+    int ranked = 0;
+    for (int i = 0; i < n; i++) if (tags[i] >= 0) ranked = 1;
+    query_stop_at_target = ranked;
+    long long peak_bytes = 0, heap_peak_total = 0;
+    long heap_peak_nodes = 0;
+    int rss_reset = mem_reset_peak_rss();
+    double wall_start = timer_now();
 
     // Run and time each query individually
     for (int i = 0; i < n; i++) {
         int s = queries[i * 2];
         int t = queries[i * 2 + 1];
 
-        double query_time;
-        double d = run_single_query(g, s, t, heap_type, &query_time);
+        double query_time, mad;
+        int timed_out, outliers;
+        double phase[NUM_PHASES];
+        uint64_t counts[PERF_NUM_EVENTS];
+        double d = run_measured_query(g, s, t, heap_type, &query_time, &timed_out, phase,
+                                      counts, &mad, &outliers);
+        mads[i] = mad;
+        outlier_total += outliers;
+        if (perf_group) {
+            if (fperf) fprintf(fperf, "%d %d", s + 1, t + 1);
+            for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+                if (counts[e] == UINT64_MAX) perf_total[e] = UINT64_MAX;
+                else if (perf_total[e] != UINT64_MAX) perf_total[e] += counts[e];
+                if (fperf) fprintf(fperf, counts[e] == UINT64_MAX ? " -1" : " %llu",
+                                   (unsigned long long)counts[e]);
+            }
+            if (fperf) fprintf(fperf, "\n");
+        }
         total_time += query_time;
+        times[i] = query_time;
+        latency_add(lat, phase);
+        // The distance array lives as long as the heap, so the peaks add up
+        long long query_peak = query_mem.peak + query_heap_mem.peak;
+        if (query_peak > peak_bytes) peak_bytes = query_peak;
+        if (query_heap_mem.peak_objects > heap_peak_nodes) heap_peak_nodes = query_heap_mem.peak_objects;
+        heap_peak_total += query_heap_mem.peak;
+#ifdef HEAP_STATS
+        heap_stats_add(&heap_total, &query_heap_stats);
+        if (fstats) {
+            fprintf(fstats, "%d %d ", s + 1, t + 1);
+            write_heap_stats(fstats, &query_heap_stats);
+        }
+#endif
 
-        if (d < DBL_MAX) reachable++;
+        if (runlog) {
+            long long counters[PERF_NUM_EVENTS + NUM_HEAP_STATS + NUM_MEM_COUNTERS];
+            int c = 0;
+            if (perf_group)
+                for (int e = 0; e < PERF_NUM_EVENTS; e++)
+                    counters[c++] = (counts[e] == UINT64_MAX) ? -1 : (long long)counts[e];
+#ifdef HEAP_STATS
+            heap_stats_values(&query_heap_stats, counters + c);
+            c += NUM_HEAP_STATS;
+#endif
+            int counted = query_mem.allocs > 0;
+            counters[c++] = counted ? query_peak : -1;
+            counters[c++] = counted ? query_heap_mem.peak : -1;
+            counters[c++] = counted ? query_heap_mem.peak_objects : -1;
+            RunStatus status = timed_out ? RUN_TIMEOUT : (d < DBL_MAX ? RUN_OK : RUN_UNREACHABLE);
+            runlog_add(runlog, s + 1, t + 1, status, d, phase, counters);
+        }
 
         // Write results to the output file
+        if (timed_out) {
+            timeouts++;
+            fprintf(fout, "%d %d TIMEOUT %.6f\n", s + 1, t + 1, query_time);
+            continue;
+        }
+        if (d < DBL_MAX) reachable++;
         fprintf(fout, "%d %d %.6f %.6f\n",
             s + 1, t + 1, d, query_time);
     }
+    double wall_time = timer_now() - wall_start;
+    long peak_rss = mem_peak_rss_kb();
+    query_stop_at_target = 0;
+    if (runlog) runlog_close(runlog, wall_time);
 
     // Print summary to console
     printf("\n=== Query File Summary ===\n");
     printf("Heap: %s\n", heap_type);
     printf("Queries: %d, Reachable: %d\n", n, reachable);
+    if (ranked) printf("Rank-tagged queries: searches stop at the target\n");
+    if (timeouts > 0)
+        printf("Timed out: %d (limit %g sec, %ld settled nodes; 0 = none)\n",
+               timeouts, query_timeout, query_max_settled);
     printf("Total time: %.6f sec (includes heap build + Dijkstra)\n", total_time);
     printf("Average time per query: %.6f sec\n", total_time / n);
+    if (query_reps > 1) {
+        // Noise of the repetitions relative to the query's own median
+        for (int i = 0; i < n; i++) mads[i] = times[i] > 0 ? mads[i] / times[i] : 0;
+        printf("Repetitions: %d per query (+%d warmup), times are medians; "
+               "median MAD %.2f%%, outlier repetitions %d of %d\n", query_reps, query_warmup,
+               100.0 * harness_median(mads, n), outlier_total, n * query_reps);
+    }
+    // Throughput of one pass over the file (wall time covers all runs)
+    latency_print(lat, wall_time / (query_warmup + query_reps));
+    latency_free(lat);
+    print_rank_summary(heap_type, tags, times, n);
+    printf("Memory (%s):\n", heap_type);
+    printf("  graph: %.2f MB (%ld edge nodes of %d bytes)\n",
+           g->mem.live / 1048576.0, g->mem.objects, (int)sizeof(Edge));
+    if (heap_peak_total > 0) {
+        printf("  per query: peak live %.2f MB max (distances + heap), heap %.2f MB avg\n",
+               peak_bytes / 1048576.0, heap_peak_total / 1048576.0 / n);
+        printf("  peak heap size: %ld nodes\n", heap_peak_nodes);
+    } else {
+        printf("  per query: not counted for \"%s\"\n", heap_type);
+    }
+    if (peak_rss >= 0)
+        printf("  peak RSS: %.2f MB (%s)\n", peak_rss / 1024.0,
+               rss_reset ? "this query file" : "since process start");
+    if (logged) printf("Run log: %s, %s\n", csv_path, json_path);
+    if (perf_group) print_perf_summary(heap_type, perf_total, n);
+    if (fperf) fclose(fperf);
+#ifdef HEAP_STATS
+    if (fstats) {
+        fprintf(fstats, "# total ");
+        write_heap_stats(fstats, &heap_total);
+        fclose(fstats);
+    }
+    printf("Heap counters (%s, all queries):\n", heap_type);
+    printf("  inserts %ld, decrease-keys %ld (+%ld no-op), extract-mins %ld\n",
+           heap_total.inserts, heap_total.decrease_keys, heap_total.decrease_noops, heap_total.extract_mins);
+    printf("  links %ld, cuts %ld, cascading cuts %ld\n",
+           heap_total.links, heap_total.cuts, heap_total.cascading_cuts);
+    printf("  root list: %.2f avg per extract-min, %ld max; max degree %ld\n",
+           heap_total.extract_mins > 0 ? (double)heap_total.root_list_total / heap_total.extract_mins : 0.0,
+           heap_total.root_list_max, heap_total.max_degree);
+#endif
+
+    fclose(fout);
+    free(queries);
+    free(tags);
+    free(times);
+    free(mads);
+}
 
+/**
+ * Runs every query of a file with both "fib" and "pair", alternating
+ * which heap goes first ('first_heap' on even queries), so slow drift
+ * such as frequency scaling, heat or background load affects both
+ * alike. Each side is measured with run_measured_query. Prints the
+ * median time per heap, the median per-query pair/fib ratio with its
+ * MAD, how often each heap was faster, and checks that both heaps
+ * return the same distances.
+ */
+void run_alternate_test(const Graph *g, const char *query_file, const char *output_file,
+                        const char *first_heap) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+    FILE *fout = fopen(output_file, "w");
+    if (!fout) {
+        free(queries);
+        return;
+    }
+    fprintf(fout, "# s t dist fib_time pair_time\n");
+
+    const char *heaps[2] = { "fib", "pair" };
+    int fib_first = strcmp(first_heap, "pair") != 0;
+    double *fib_times = malloc(n * sizeof(double));
+    double *pair_times = malloc(n * sizeof(double));
+    double *ratios = malloc(n * sizeof(double));
+    int measured = 0, skipped = 0, mismatches = 0, fib_wins = 0;
+
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2];
+        int t = queries[i * 2 + 1];
+        double dist[2], time[2], phase[NUM_PHASES], mad;
+        uint64_t counts[PERF_NUM_EVENTS];
+        int timed_out[2], outliers;
+        for (int k = 0; k < 2; k++) {
+            // k-th run of this query: fib first on even queries if fib_first
+            int h = ((i + k) % 2 == 0) == fib_first ? 0 : 1;
+            dist[h] = run_measured_query(g, s, t, heaps[h], &time[h], &timed_out[h], phase,
+                                         counts, &mad, &outliers);
+        }
+        if (timed_out[0] || timed_out[1]) {
+            skipped++;
+            fprintf(fout, "%d %d TIMEOUT %.6f %.6f\n", s + 1, t + 1, time[0], time[1]);
+            continue;
+        }
+        if (dist[0] != dist[1]) mismatches++;
+        fprintf(fout, "%d %d %.6f %.6f %.6f\n", s + 1, t + 1, dist[0], time[0], time[1]);
+        fib_times[measured] = time[0];
+        pair_times[measured] = time[1];
+        ratios[measured] = time[0] > 0 ? time[1] / time[0] : 1.0;
+        if (time[0] < time[1]) fib_wins++;
+        measured++;
+    }
     fclose(fout);
+
+    printf("\n=== Alternating fib / pair ===\n");
+    printf("Queries: %d measured, %d skipped (timeout); %d repetitions (+%d warmup) per heap and query\n",
+           measured, skipped, query_reps, query_warmup);
+    if (measured > 0) {
+        double ratio = harness_median(ratios, measured);
+        double ratio_mad = harness_mad(ratios, measured, ratio);
+        printf("Median time: fib %.6f sec, pair %.6f sec\n",
+               harness_median(fib_times, measured), harness_median(pair_times, measured));
+        printf("pair / fib per query: median %.3f (MAD %.3f); fib faster on %d, pair on %d\n",
+               ratio, ratio_mad, fib_wins, measured - fib_wins);
+    }
+    printf("Distance mismatches: %d\n", mismatches);
+    printf("Results: %s\n", output_file);
+
+    free(queries);
+    free(fib_times);
+    free(pair_times);
+    free(ratios);
+}
+
+/**
+ * Runs a query file on the multithreaded batch executor.
+ * Results are written to 'output_file' in input order, in the same
+ * "s t dist time" format as run_query_test.
+ */
+void run_batch_test(const Graph *g, const char *query_file, const char *output_file,
+                    const char *heap_type, int threads) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    BatchResult *results = malloc(n * sizeof(BatchResult));
+    BatchStats stats;
+    if (run_query_batch(g, queries, n, heap_type, threads, results, &stats) != 0) {
+        fprintf(stderr, "Unknown heap type for batch mode: %s\n", heap_type);
+        free(results);
+        free(queries);
+        return;
+    }
+
+    FILE *fout = fopen(output_file, "w");
+    int reachable = 0;
+    double lat_sum = 0, lat_max = 0, cpu_sum = 0;
+    int *per_worker = calloc(stats.num_workers, sizeof(int));
+
+    for (int i = 0; i < n; i++) {
+        BatchResult *r = &results[i];
+        if (r->dist < DBL_MAX) reachable++;
+        lat_sum += r->latency;
+        if (r->latency > lat_max) lat_max = r->latency;
+        cpu_sum += r->cpu_time;
+        per_worker[r->worker]++;
+        if (fout) {
+            fprintf(fout, "%d %d %.6f %.6f\n",
+                queries[i * 2] + 1, queries[i * 2 + 1] + 1, r->dist, r->latency);
+        }
+    }
+    if (fout) fclose(fout);
+
+    int wmin = n, wmax = 0;
+    for (int w = 0; w < stats.num_workers; w++) {
+        if (per_worker[w] < wmin) wmin = per_worker[w];
+        if (per_worker[w] > wmax) wmax = per_worker[w];
+    }
+
+    printf("\n=== Batch Summary ===\n");
+    printf("Heap: %s, workers: %d\n", heap_type, stats.num_workers);
+    printf("Queries: %d, Reachable: %d\n", n, reachable);
+    printf("Batch wall time: %.6f sec\n", stats.wall_time);
+    printf("Throughput: %.2f queries/sec\n", stats.wall_time > 0 ? n / stats.wall_time : 0.0);
+    printf("Per-query latency: avg %.6f sec, max %.6f sec (search only)\n", lat_sum / n, lat_max);
+    printf("Per-query thread CPU time: avg %.6f sec\n", cpu_sum / n);
+    // Latencies include time spent descheduled, so only CPU time shows oversubscription
+    printf("Parallel efficiency: %.2f (sum of thread CPU times / (wall * workers))\n",
+           stats.wall_time > 0 ? cpu_sum / (stats.wall_time * stats.num_workers) : 0.0);
+#ifdef _OPENMP
+    if (stats.num_workers > omp_get_num_procs())
+        printf("Warning: %d workers on %d processors; latencies include time waiting for a core\n",
+               stats.num_workers, omp_get_num_procs());
+#endif
+    printf("Work stealing: %ld steals, %ld queries moved, %d..%d queries per worker\n",
+           stats.steals, stats.stolen, wmin, wmax);
+
+    free(per_worker);
+    free(results);
+    free(queries);
+}
+
+// Runs one multi-target search with the selected heap. Returns settled nodes, or -1.
+static int run_targets(const Graph *g, int s, const int *targets, int nt, const char *heap_type, double *out) {
+    if (strcmp(heap_type, "fib") == 0)
+        return dijkstra_fib_targets(g, s, targets, nt, out);
+    if (strcmp(heap_type, "pair") == 0)
+        return dijkstra_pair_targets(g, s, targets, nt, out);
+    return -1;
+}
+
+/**
+ * Runs a query file grouped by source: one multi-target search answers
+ * every pair that shares a source and stops once all of its targets are
+ * settled. Results are written to 'output_file' in input order; the
+ * time column is the group's search time split evenly over its queries.
+ * With 'compare' set, the same pairs are also run one search per pair
+ * (with the same early exit) to show the saving.
+ */
+void run_grouped_test(const Graph *g, const char *query_file, const char *output_file,
+                      const char *heap_type, int compare) {
+    if (strcmp(heap_type, "fib") != 0 && strcmp(heap_type, "pair") != 0) {
+        fprintf(stderr, "Unknown heap type for grouped mode: %s\n", heap_type);
+        return;
+    }
+
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    double plan_start = timer_now();
+    QueryPlan *plan = plan_by_source(queries, n);
+    double plan_time = timer_now() - plan_start;
+
+    double *dist = malloc(n * sizeof(double));
+    double *qtime = malloc(n * sizeof(double));
+    int *targets = malloc(n * sizeof(int));
+    double *out = malloc(n * sizeof(double));
+    int *slot = malloc(n * sizeof(int));
+    long settled_sum = 0;
+    int searches = 0, largest = 0;
+
+    double start = timer_now();
+    for (int k = 0; k < plan->num_groups; k++) {
+        int first = plan->group_start[k], last = plan->group_start[k + 1];
+        int s = queries[plan->order[first] * 2];
+        if (last - first > largest) largest = last - first;
+
+        // Collect the group's valid targets; invalid pairs are unreachable
+        int nt = 0;
+        for (int j = first; j < last; j++) {
+            int qi = plan->order[j];
+            int t = queries[qi * 2 + 1];
+            dist[qi] = DBL_MAX;
+            qtime[qi] = 0;
+            if (s < 0 || s >= g->num_nodes || t < 0 || t >= g->num_nodes) continue;
+            slot[nt] = qi;
+            targets[nt++] = t;
+        }
+        if (nt == 0) continue;
+
+        double st = timer_now();
+        settled_sum += run_targets(g, s, targets, nt, heap_type, out);
+        double elapsed = timer_now() - st;
+        searches++;
+
+        for (int j = 0; j < nt; j++) {
+            dist[slot[j]] = out[j];
+            qtime[slot[j]] = elapsed / nt;
+        }
+    }
+    double grouped_time = timer_now() - start;
+
+    FILE *fout = fopen(output_file, "w");
+    int reachable = 0;
+    for (int i = 0; i < n; i++) {
+        if (dist[i] < DBL_MAX) reachable++;
+        if (fout) {
+            fprintf(fout, "%d %d %.6f %.6f\n",
+                queries[i * 2] + 1, queries[i * 2 + 1] + 1, dist[i], qtime[i]);
+        }
+    }
+    if (fout) fclose(fout);
+
+    printf("\n=== Grouped Query Summary ===\n");
+    printf("Heap: %s\n", heap_type);
+    printf("Queries: %d, Reachable: %d\n", n, reachable);
+    printf("Distinct sources: %d (largest group: %d queries)\n", plan->num_groups, largest);
+    printf("Searches run: %d, searches saved: %d\n", searches, n - plan->num_groups);
+    printf("Planning time: %.6f sec\n", plan_time);
+    printf("Grouped time: %.6f sec, avg settled per search: %.1f\n",
+           grouped_time, searches ? (double)settled_sum / searches : 0.0);
+
+    if (compare) {
+        // Baseline: one early-exit search per pair, in input order
+        int mismatches = 0;
+        long base_settled = 0;
+        double base_start = timer_now();
+        for (int i = 0; i < n; i++) {
+            int s = queries[i * 2], t = queries[i * 2 + 1];
+            double d = DBL_MAX;
+            if (s >= 0 && s < g->num_nodes && t >= 0 && t < g->num_nodes)
+                base_settled += run_targets(g, s, &t, 1, heap_type, &d);
+            if (d != dist[i]) mismatches++;
+        }
+        double base_time = timer_now() - base_start;
+        printf("Per-pair time: %.6f sec, avg settled per search: %.1f\n",
+               base_time, (double)base_settled / n);
+        printf("Speedup: %.2fx, mismatches: %d\n",
+               grouped_time > 0 ? base_time / grouped_time : 0.0, mismatches);
+    }
+
+    free(slot);
+    free(out);
+    free(targets);
+    free(qtime);
+    free(dist);
+    free_query_plan(plan);
     free(queries);
 }
 
@@ -164,24 +932,19 @@ void run_random(const Graph *g, int num, int seed, int verbose, const char *heap
     printf("Source = %d\n", s + 1);
     printf("Queries = %d\n", num);
 
-    // 1. Time the full SSSP computation
-    clock_t t1 = clock();
-    double *dist = NULL;
-    if (strcmp(heap_type, "fib") == 0)
-        dist = dijkstra_fibheap(g, s);
-    else if (strcmp(heap_type, "pair") == 0)
-        dist = dijkstra_pairingheap(g, s);
-    else {
+    // 1. Time the full SSSP computation (wall clock, see run_single_query)
+    double t1 = timer_now();
+    double *dist = run_sssp(g, s, heap_type);
+    if (!dist) {
         fprintf(stderr, "Unknown heap type: %s\n", heap_type);
         return;
     }
-    clock_t t2 = clock();
-    double preprocess_time = (double)(t2 - t1) / CLOCKS_PER_SEC;
+    double preprocess_time = timer_now() - t1;
     
     printf("%s heap build + Dijkstra: %.6f sec\n", heap_type, preprocess_time);
 
     // 2. Time 'num' random lookups in the 'dist' array
-    clock_t q1 = clock();
+    double q1 = timer_now();
     for (int i = 0; i < num; i++) {
         int t = rand() % g->num_nodes;
         // Use volatile to prevent the compiler from optimizing away the lookup
@@ -190,8 +953,7 @@ void run_random(const Graph *g, int num, int seed, int verbose, const char *heap
             printf("Query %d: t=%d value=%.0f\n", i+1, t+1, dval);
         }
     }
-    clock_t q2 = clock();
-    double qtime = (double)(q2 - q1) / CLOCKS_PER_SEC;
+    double qtime = timer_now() - q1;
     
     // Print summary
     printf("\nDistance lookup only time: %.6f sec for %d lookups\n", qtime, num);
@@ -201,64 +963,1560 @@ void run_random(const Graph *g, int num, int seed, int verbose, const char *heap
     free(dist);
 }
 
-// Prints the command-line usage instructions.
-void usage(const char *prog) {
-    printf("Usage:\n");
-    printf("  %s <graph_file> <query_file|random|query_dir> <heap_type> [options]\n", prog);
-    printf("heap_type: fib | pair\n");
-    printf("Examples:\n");
-    printf("  %s data/USA-road-d.USA.gr queries/q1.qry fib\n", prog);
-    printf("  %s data/USA-road-d.USA.gr random pair 1000 12345 1\n", prog);
-    printf("  %s data/USA-road-d.USA.gr query_dir fib\n", prog);
-    printf("\nNote: Query time includes heap build + Dijkstra execution time\n");
+/**
+ * Checks CRP answers against plain Dijkstra on the first
+ * CRP_VERIFY_QUERIES valid queries. Prints the baseline average
+ * time and returns the number of mismatching distances. Queries whose
+ * reference search hits the per-query budget (query_timeout,
+ * query_max_settled) have no reference distance; they are skipped and
+ * counted separately.
+ */
+static int crp_verify(const Graph *g, CrpQuery *cq, const int *queries, int n, const char *heap_type) {
+    int checked = 0, mismatches = 0, timeouts = 0;
+    double base_time = 0;
+
+    for (int i = 0; i < n && checked < CRP_VERIFY_QUERIES; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+
+        double query_time;
+        int timed_out;
+        double expected = run_single_query(g, s, t, heap_type, &query_time, &timed_out, NULL);
+        if (timed_out) {
+            timeouts++;
+            continue;
+        }
+        double got = crp_query(cq, s, t, NULL);
+        base_time += query_time;
+        checked++;
+
+        if (got != expected) {
+            mismatches++;
+            if (mismatches <= 5)
+                printf("  Mismatch %d -> %d: crp=%.6f dijkstra=%.6f\n", s + 1, t + 1, got, expected);
+        }
+    }
+
+    if (checked > 0)
+        printf("Baseline %s Dijkstra: %.6f sec avg over %d queries, mismatches: %d\n",
+               heap_type, base_time / checked, checked, mismatches);
+    if (timeouts > 0)
+        printf("Not verified: %d queries hit the baseline limit (%g sec, %ld settled nodes; 0 = none)\n",
+               timeouts, query_timeout, query_max_settled);
+    return mismatches;
 }
 
 /**
- * Main entry point for the benchmark executable.
+ * Times every query of the file on the CRP overlay.
+ * Returns the average query time in seconds.
  */
-int main(int argc, char *argv[]) {
-    if (argc < 4) {
-        usage(argv[0]);
-        return 0;
+static double crp_time_queries(const Graph *g, CrpQuery *cq, const int *queries, int n, double *avg_settled) {
+    double total = 0;
+    long settled_sum = 0;
+    int done = 0;
+
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+
+        int settled;
+        double st = timer_now();
+        crp_query(cq, s, t, &settled);
+        total += timer_now() - st;
+        settled_sum += settled;
+        done++;
     }
 
-    const char *graph_file = argv[1];
-    const char *heap_type = argv[3];
+    *avg_settled = done ? (double)settled_sum / done : 0;
+    return done ? total / done : 0;
+}
+
+/**
+ * Runs the CRP (multi-level partition overlay) benchmark.
+ *
+ * 1. Partitions the graph and builds the overlay (metric-independent).
+ * 2. Customizes the cliques in parallel and times it.
+ * 3. Times every query of 'query_file' on the overlay and checks a
+ *    prefix of them against plain Dijkstra.
+ * 4. Simulates a traffic update (1% of the arcs get slower),
+ *    re-customizes, and times/checks the queries again.
+ */
+void run_crp(Graph *g, const char *query_file, const char *heap_type,
+             int levels, int base_cell, int threads, int seed) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+#ifdef _OPENMP
+    if (threads > 0) omp_set_num_threads(threads);
+    threads = omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-    if (!file_exists(graph_file)) {
-        fprintf(stderr, "Graph file not found\n");
-        return -1;
+    // Cell sizes grow by a factor of 16 per level
+    int sizes[16];
+    if (levels < 1) levels = 1;
+    if (levels > 16) levels = 16;
+    for (int l = 0; l < levels; l++) {
+        long size = (long)base_cell << (4 * l);
+        sizes[l] = size > g->num_nodes ? g->num_nodes : (int)size;
     }
 
-    // Load the graph from file
-    Graph *g = load_dimacs_graph(graph_file);
-    printf("Graph loaded: %d nodes\n", g->num_nodes);
-    printf("==========================================\n");
+    printf("CRP benchmark mode\n");
+    printf("Levels = %d, base cell size = %d, threads = %d\n", levels, base_cell, threads);
 
-    const char *q = argv[2]; // The mode/query file argument
+    // 1. Metric-independent preprocessing
+    double t0 = timer_now();
+    CrpOverlay *o = crp_build(g, levels, sizes);
+    double build_time = timer_now() - t0;
 
-    // Mode 1: "random"
-    if (strcmp(q, "random") == 0) {
-        if (argc < 5) {
-            printf("Missing num_queries\n");
-            usage(argv[0]);
-            free_graph(g);
-            return -1;
-        }
+    const Partition *p = crp_partition(o);
+    printf("Partition + overlay build: %.6f sec\n", build_time);
+    for (int l = 0; l < levels; l++) {
+        printf("  Level %d: max size %d, %d cells, %ld clique entries\n",
+               l, sizes[l], p->num_cells[l], crp_num_clique_entries(o, l));
+    }
+    printf("  Overlay nodes: %d (%.2f%% of graph)\n",
+           crp_num_overlay_nodes(o), 100.0 * crp_num_overlay_nodes(o) / g->num_nodes);
 
-        int n = atoi(argv[4]);
-        int seed = (argc >= 6) ? atoi(argv[5]) : (int)time(NULL);
-        int verbose = (argc >= 7) ? atoi(argv[6]) : 0;
+    // 2. Customization
+    t0 = timer_now();
+    crp_customize(o);
+    double cust_time = timer_now() - t0;
+    printf("Customization: %.6f sec\n", cust_time);
 
-        run_random(g, n, seed, verbose, heap_type);
-        free_graph(g);
-        return 0;
+    // 3. Queries
+    CrpQuery *cq = crp_query_create(o);
+    double avg_settled;
+    double avg_query = crp_time_queries(g, cq, queries, n, &avg_settled);
+    printf("CRP query: %.6f sec avg, %.1f nodes scanned avg (%d queries)\n", avg_query, avg_settled, n);
+    crp_verify(g, cq, queries, n, heap_type);
+
+    // 4. Weight change: slow down 1% of the arcs by up to 2x, then re-customize
+    srand(seed);
+    long changed = 0;
+    long target = g->num_edges / 100 + 1;
+    while (changed < target) {
+        int u = rand() % g->num_nodes;
+        Edge *e = g->adj[u];
+        if (!e) continue;
+        double w = e->weight * (1.0 + (double)rand() / RAND_MAX);
+        update_edge_weight(g, u, e->to, (double)(long)w);
+        changed++;
     }
+    printf("\nUpdated %ld arc weights\n", changed);
+
+    t0 = timer_now();
+    crp_customize(o);
+    cust_time = timer_now() - t0;
+    printf("Re-customization: %.6f sec\n", cust_time);
+
+    avg_query = crp_time_queries(g, cq, queries, n, &avg_settled);
+    printf("CRP query: %.6f sec avg, %.1f nodes scanned avg\n", avg_query, avg_settled);
+    crp_verify(g, cq, queries, n, heap_type);
+
+    crp_query_free(cq);
+    crp_free(o);
+    free(queries);
+}
+
+/**
+ * Writes a distance table as dense binary: int32 rows, int32 cols,
+ * then rows * cols doubles in row-major order (DBL_MAX = unreachable).
+ * Returns 0 on success.
+ */
+static int write_table(const char *path, const double *table, int rows, int cols) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    int32_t dims[2] = { rows, cols };
+    size_t cells = (size_t)rows * cols;
+    int ok = fwrite(dims, sizeof(int32_t), 2, f) == 2 &&
+             fwrite(table, sizeof(double), cells, f) == cells;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+/**
+ * Runs the many-to-many distance table benchmark.
+ *
+ * The first 'max_endpoints' queries of 'query_file' give the source set
+ * (their s) and the target set (their t). The table is computed on a
+ * CRP overlay with bucket-based backward-then-forward searches and
+ * written to 'output_file'. The naive approach (one full SSSP per row
+ * with 'heap_type') is timed on the first 'naive_rows' rows, which are
+ * also checked against the table, and extrapolated to all rows.
+ */
+void run_table(const Graph *g, const char *query_file, const char *output_file, const char *heap_type,
+               int max_endpoints, int naive_rows, int levels, int base_cell, int threads) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+#ifdef _OPENMP
+    if (threads > 0) omp_set_num_threads(threads);
+    threads = omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    int k = (max_endpoints > 0 && max_endpoints < n) ? max_endpoints : n;
+    int *sources = malloc(k * sizeof(int));
+    int *targets = malloc(k * sizeof(int));
+    for (int i = 0; i < k; i++) {
+        sources[i] = queries[i * 2];
+        targets[i] = queries[i * 2 + 1];
+    }
+
+    // Cell sizes grow by a factor of 16 per level (as in run_crp)
+    int sizes[16];
+    if (levels < 1) levels = 1;
+    if (levels > 16) levels = 16;
+    for (int l = 0; l < levels; l++) {
+        long size = (long)base_cell << (4 * l);
+        sizes[l] = size > g->num_nodes ? g->num_nodes : (int)size;
+    }
+
+    printf("Distance table mode\n");
+    printf("Table: %d x %d, levels = %d, base cell size = %d, threads = %d\n",
+           k, k, levels, base_cell, threads);
+
+    double t0 = timer_now();
+    CrpOverlay *o = crp_build(g, levels, sizes);
+    crp_customize(o);
+    printf("Overlay build + customization: %.6f sec\n", timer_now() - t0);
+
+    double *table = malloc((size_t)k * k * sizeof(double));
+    t0 = timer_now();
+    long settled = crp_distance_table(o, sources, k, targets, k, table);
+    double table_time = timer_now() - t0;
+    printf("Bucket table: %.6f sec, %.1f nodes settled per search\n",
+           table_time, (double)settled / (2.0 * k));
+
+    if (write_table(output_file, table, k, k) == 0)
+        printf("Table written to %s\n", output_file);
+    else
+        fprintf(stderr, "Failed to write %s\n", output_file);
+
+    // Naive baseline: one full SSSP per row
+    int rows = (naive_rows > 0 && naive_rows < k) ? naive_rows : k;
+    int mismatches = 0;
+    t0 = timer_now();
+    for (int i = 0; i < rows; i++) {
+        int s = sources[i];
+        if (s < 0 || s >= g->num_nodes) continue;
+        double *dist = run_sssp(g, s, heap_type);
+        if (!dist) {
+            fprintf(stderr, "Unknown heap type: %s\n", heap_type);
+            break;
+        }
+        for (int j = 0; j < k; j++) {
+            int t = targets[j];
+            double expected = (t >= 0 && t < g->num_nodes) ? dist[t] : DBL_MAX;
+            if (table[(long)i * k + j] != expected) mismatches++;
+        }
+        free(dist);
+    }
+    double naive_time = timer_now() - t0;
+    double naive_full = naive_time * k / rows;
+    printf("Naive %s row-by-row: %.6f sec for %d rows (%.6f sec extrapolated to %d rows)\n",
+           heap_type, naive_time, rows, naive_full, k);
+    printf("Speedup: %.2fx, mismatches in checked rows: %d\n",
+           table_time > 0 ? naive_full / table_time : 0.0, mismatches);
+
+    free(table);
+    crp_free(o);
+    free(sources);
+    free(targets);
+    free(queries);
+}
+
+/**
+ * Runs one point-to-point query with the selected heap, optionally
+ * pruned by arc flags. Wall time is stored in 'time_used'.
+ */
+static double run_p2p_query(const Graph *g, int s, int t, const char *heap_type, const ArcFlags *af,
+                            double *time_used, int *settled, long *scanned, long *pruned) {
+    double st = timer_now();
+    double d;
+    if (strcmp(heap_type, "pair") == 0)
+        d = dijkstra_pair_p2p(g, s, t, af, settled, scanned, pruned);
+    else
+        d = dijkstra_fib_p2p(g, s, t, af, settled, scanned, pruned);
+    *time_used = timer_now() - st;
+    return d;
+}
+
+/**
+ * Runs the arc-flags benchmark.
+ * Builds flags for 'regions' regions, then answers every query of
+ * 'query_file' twice with the same point-to-point kernel: once plain
+ * and once pruned. Reports the pruning rate and the speedup.
+ */
+void run_arcflags(const Graph *g, const char *query_file, const char *heap_type, int regions, int threads) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+#ifdef _OPENMP
+    if (threads > 0) omp_set_num_threads(threads);
+    threads = omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    printf("Arc flags benchmark mode\n");
+    printf("Requested regions = %d, threads = %d, heap = %s\n", regions, threads, heap_type);
+
+    double t0 = timer_now();
+    ArcFlags *af = arcflags_build(g, regions);
+    double pre_time = timer_now() - t0;
+    printf("Preprocessing: %.6f sec, %d regions, %.2f MB of flags\n",
+           pre_time, af->num_regions, arcflags_bytes(af) / (1024.0 * 1024.0));
+
+    double plain_time = 0, flag_time = 0;
+    long plain_settled = 0, flag_settled = 0;
+    long plain_scanned = 0, flag_scanned = 0, flag_pruned = 0;
+    int done = 0, mismatches = 0;
+
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+
+        double tp, tf;
+        int sp, sf;
+        long cp, cf, pf;
+        double dp = run_p2p_query(g, s, t, heap_type, NULL, &tp, &sp, &cp, NULL);
+        double df = run_p2p_query(g, s, t, heap_type, af, &tf, &sf, &cf, &pf);
+
+        plain_time += tp;
+        flag_time += tf;
+        plain_settled += sp;
+        flag_settled += sf;
+        plain_scanned += cp;
+        flag_scanned += cf;
+        flag_pruned += pf;
+        done++;
+
+        if (dp != df) {
+            mismatches++;
+            if (mismatches <= 5)
+                printf("  Mismatch %d -> %d: flags=%.6f plain=%.6f\n", s + 1, t + 1, df, dp);
+        }
+    }
+
+    if (done > 0) {
+        printf("\n=== Arc Flags Summary ===\n");
+        printf("Queries: %d, mismatches: %d\n", done, mismatches);
+        printf("Plain p2p:  %.6f sec avg, %.1f settled avg, %.1f arcs scanned avg\n",
+               plain_time / done, (double)plain_settled / done, (double)plain_scanned / done);
+        printf("Arc flags:  %.6f sec avg, %.1f settled avg, %.1f arcs scanned avg\n",
+               flag_time / done, (double)flag_settled / done, (double)flag_scanned / done);
+        long seen = flag_scanned + flag_pruned;
+        printf("Pruning rate: %.2f%% of arcs at settled nodes skipped\n",
+               seen ? 100.0 * flag_pruned / seen : 0.0);
+        printf("Search space reduction: %.2fx settled, speedup: %.2fx\n",
+               flag_settled ? (double)plain_settled / flag_settled : 0.0,
+               flag_time > 0 ? plain_time / flag_time : 0.0);
+    }
+
+    free_arcflags(af);
+    free(queries);
+}
+
+/**
+ * Runs a query file through the interleaved executor on one core.
+ *
+ * The queries are answered three times: one after the other with the
+ * 'heap_type' point-to-point kernel (baseline), and by the interleaved
+ * executor with width 1 and with 'width' searches in flight. The
+ * interleaved results are checked against the baseline, and the width
+ * 'width' results are written to 'output_file' ("s t dist latency").
+ */
+void run_interleave_test(const Graph *g, const char *query_file, const char *output_file,
+                         const char *heap_type, int width) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    // 1. Baseline: one early-exit search per query
+    double *expected = malloc(n * sizeof(double));
+    double base_time = 0;
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        expected[i] = DBL_MAX;
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+        double qt;
+        int settled;
+        expected[i] = run_p2p_query(g, s, t, heap_type, NULL, &qt, &settled, NULL, NULL);
+        base_time += qt;
+    }
+
+    // 2. Interleaved executor, sequential (width 1) and 'width' wide
+    InterleaveResult *seq = malloc(n * sizeof(InterleaveResult));
+    InterleaveResult *wide = malloc(n * sizeof(InterleaveResult));
+    double t0 = timer_now();
+    run_interleaved(g, queries, n, 1, seq);
+    double seq_time = timer_now() - t0;
+    t0 = timer_now();
+    run_interleaved(g, queries, n, width, wide);
+    double wide_time = timer_now() - t0;
+
+    int mismatches = 0, reachable = 0;
+    FILE *fout = fopen(output_file, "w");
+    for (int i = 0; i < n; i++) {
+        if (wide[i].dist != expected[i] || seq[i].dist != expected[i]) mismatches++;
+        if (wide[i].dist < DBL_MAX) reachable++;
+        if (fout) {
+            fprintf(fout, "%d %d %.6f %.6f\n",
+                queries[i * 2] + 1, queries[i * 2 + 1] + 1, wide[i].dist, wide[i].latency);
+        }
+    }
+    if (fout) fclose(fout);
+
+    printf("\n=== Interleaved Query Summary ===\n");
+    printf("Queries: %d, Reachable: %d, width: %d\n", n, reachable, width);
+    printf("Baseline %s p2p: %.6f sec, %.2f queries/sec\n",
+           heap_type, base_time, base_time > 0 ? n / base_time : 0.0);
+    printf("Interleaved, width 1: %.6f sec, %.2f queries/sec\n",
+           seq_time, seq_time > 0 ? n / seq_time : 0.0);
+    printf("Interleaved, width %d: %.6f sec, %.2f queries/sec\n",
+           width, wide_time, wide_time > 0 ? n / wide_time : 0.0);
+    printf("Speedup: %.2fx vs width 1, %.2fx vs baseline, mismatches: %d\n",
+           wide_time > 0 ? seq_time / wide_time : 0.0,
+           wide_time > 0 ? base_time / wide_time : 0.0, mismatches);
+
+    free(seq);
+    free(wide);
+    free(expected);
+    free(queries);
+}
+
+/**
+ * Compares sequential and concurrent bidirectional Dijkstra.
+ * Every query of 'query_file' runs with the 'heap_type' point-to-point
+ * kernel (reference), the one-thread bidirectional search and the
+ * two-thread bidirectional search. Reports total times, expanded nodes
+ * and mismatches against the reference.
+ */
+void run_bidi_test(const Graph *g, const char *query_file, const char *heap_type) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    double ref_time = 0, seq_time = 0, conc_time = 0;
+    long seq_expanded = 0, conc_expanded = 0;
+    int checked = 0, seq_bad = 0, conc_bad = 0;
+
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+        checked++;
+
+        double qt;
+        int settled, f, b;
+        double ref = run_p2p_query(g, s, t, heap_type, NULL, &qt, &settled, NULL, NULL);
+        ref_time += qt;
+
+        double t0 = timer_now();
+        double d = dijkstra_bi_one_query(g, s, t, &f, &b);
+        seq_time += timer_now() - t0;
+        seq_expanded += f + b;
+        if (d != ref) seq_bad++;
+
+        t0 = timer_now();
+        d = dijkstra_bi_concurrent(g, s, t, &f, &b);
+        conc_time += timer_now() - t0;
+        conc_expanded += f + b;
+        if (d != ref) conc_bad++;
+    }
+
+    if (checked == 0) {
+        fprintf(stderr, "No valid queries in %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    printf("\n=== Bidirectional Summary ===\n");
+    printf("Queries: %d\n", checked);
+    printf("%-22s %-12s %-12s %-14s %s\n", "Search", "Total(s)", "Avg(s)", "Expanded avg", "Mismatches");
+    printf("%-22s %-12.6f %-12.6f %-14s %s\n", heap_type, ref_time, ref_time / checked, "-", "-");
+    printf("%-22s %-12.6f %-12.6f %-14.1f %d\n", "bidirectional (1 thr)",
+           seq_time, seq_time / checked, (double)seq_expanded / checked, seq_bad);
+    printf("%-22s %-12.6f %-12.6f %-14.1f %d\n", "bidirectional (2 thr)",
+           conc_time, conc_time / checked, (double)conc_expanded / checked, conc_bad);
+    printf("Concurrent speedup: %.2fx vs 1 thread\n", conc_time > 0 ? seq_time / conc_time : 0.0);
+
+    free(queries);
+}
+
+/**
+ * Runs the degree-2 chain contraction benchmark.
+ *
+ * Contracts the graph, reports the node and arc reduction, checks that
+ * every shortcut expands back into original arcs of the same length,
+ * then compares 'num_sssp' random full SSSPs (original vs contracted,
+ * same heap) and the queries of 'query_file' (point-to-point on the
+ * contracted graph vs run_p2p_query on the original graph).
+ */
+void run_contract(const Graph *g, const char *query_file, const char *heap_type, int num_sssp, int seed) {
+    if (strcmp(heap_type, "fib") != 0 && strcmp(heap_type, "pair") != 0) {
+        fprintf(stderr, "Unknown heap type for contract mode: %s\n", heap_type);
+        return;
+    }
+    int n = g->num_nodes;
+
+    double t0 = timer_now();
+    Contraction *c = contract_graph(g);
+    double build_time = timer_now() - t0;
+
+    printf("Chain contraction mode\n");
+    printf("Contraction: %.6f sec, %d chains\n", build_time, c->num_chains);
+    printf("Nodes: %d -> %d (-%.2f%%)\n", n, c->g->num_nodes,
+           n ? 100.0 * (n - c->g->num_nodes) / n : 0.0);
+    printf("Arcs:  %ld -> %ld (-%.2f%%)\n", g->num_edges, c->g->num_edges,
+           g->num_edges ? 100.0 * (g->num_edges - c->g->num_edges) / g->num_edges : 0.0);
+
+    // 1. Every arc of the contracted graph must expand into an original path of equal length
+    int *path = malloc((n > 0 ? n : 1) * sizeof(int));
+    long shortcuts = 0, bad_arcs = 0;
+    for (int u = 0; u < c->g->num_nodes; u++) {
+        for (Edge *e = c->g->adj[u]; e; e = e->next) {
+            int len = contract_expand_arc(c, u, e->to, e->weight, path, n);
+            if (len < 0) { bad_arcs++; continue; }
+            if (len == 0) continue;
+            shortcuts++;
+            double sum = 0;
+            int prev = c->old_id[u];
+            for (int i = 0; i <= len; i++) {
+                int next = (i < len) ? path[i] : c->old_id[e->to];
+                double w = DBL_MAX;
+                for (Edge *a = g->adj[prev]; a; a = a->next)
+                    if (a->to == next && a->weight < w) w = a->weight;
+                sum = (w < DBL_MAX && sum < DBL_MAX) ? sum + w : DBL_MAX;
+                prev = next;
+            }
+            if (sum != e->weight) bad_arcs++;
+        }
+    }
+    printf("Shortcut expansion: %ld shortcuts, %ld bad arcs\n", shortcuts, bad_arcs);
+    free(path);
+
+    // 2. Full SSSPs from random sources
+    srand(seed);
+    double *dc = malloc(n * sizeof(double));
+    double orig_time = 0, cont_time = 0;
+    long sssp_bad = 0;
+    for (int i = 0; i < num_sssp; i++) {
+        int s = rand() % n;
+        t0 = timer_now();
+        double *ref = run_sssp(g, s, heap_type);
+        orig_time += timer_now() - t0;
+
+        t0 = timer_now();
+        contract_sssp(c, s, heap_type, dc);
+        cont_time += timer_now() - t0;
+
+        for (int v = 0; v < n; v++) if (dc[v] != ref[v]) sssp_bad++;
+        free(ref);
+    }
+    if (num_sssp > 0) {
+        printf("SSSP (%s, %d sources): original %.6f sec avg, contracted %.6f sec avg, "
+               "speedup %.2fx, mismatches %ld\n", heap_type, num_sssp,
+               orig_time / num_sssp, cont_time / num_sssp,
+               cont_time > 0 ? orig_time / cont_time : 0.0, sssp_bad);
+    }
+    free(dc);
+
+    // 3. Point-to-point queries, including endpoints inside chains
+    int *queries = NULL;
+    int nq = query_file ? load_query_pairs(query_file, &queries) : 0;
+    double p2p_orig = 0, p2p_cont = 0;
+    int checked = 0, p2p_bad = 0;
+    for (int i = 0; i < nq; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        if (s < 0 || t < 0 || s >= n || t >= n) continue;
+        double qt;
+        int settled;
+        double ref = run_p2p_query(g, s, t, heap_type, NULL, &qt, &settled, NULL, NULL);
+        p2p_orig += qt;
+        t0 = timer_now();
+        double d = contract_query(c, s, t, heap_type);
+        p2p_cont += timer_now() - t0;
+        if (d != ref) p2p_bad++;
+        checked++;
+    }
+    if (checked > 0) {
+        printf("P2P (%d queries): original %.6f sec, contracted %.6f sec, speedup %.2fx, mismatches %d\n",
+               checked, p2p_orig, p2p_cont, p2p_cont > 0 ? p2p_orig / p2p_cont : 0.0, p2p_bad);
+    }
+
+    free(queries);
+    free_contraction(c);
+}
+
+/**
+ * Runs the approximate (1+eps) bucket-queue benchmark.
+ *
+ * Every query of 'query_file' is answered exactly with the 'heap_type'
+ * point-to-point kernel, then once per value of the comma-separated
+ * 'eps_list' with the approximate search, using bucket width 'rule'.
+ * For each eps, reports the total time (including workspace setup), the
+ * speedup over the exact kernel, the mean and max relative error, how
+ * many answers were not exact and how many broke the (1+eps) bound
+ * (must be 0 with APPROX_WIDTH_MIN; APPROX_WIDTH_MEAN makes no promise).
+ */
+void run_approx_test(const Graph *g, const char *query_file, const char *heap_type, const char *eps_list,
+                     ApproxWidth rule) {
+    int *queries = NULL;
+    int n = load_query_pairs(query_file, &queries);
+    if (n == 0) {
+        fprintf(stderr, "No queries loaded from %s\n", query_file);
+        free(queries);
+        return;
+    }
+
+    // 1. Exact reference
+    double *exact = malloc(n * sizeof(double));
+    double exact_time = 0;
+    int checked = 0;
+    for (int i = 0; i < n; i++) {
+        int s = queries[i * 2], t = queries[i * 2 + 1];
+        exact[i] = -1; // Marks an invalid pair
+        if (s < 0 || t < 0 || s >= g->num_nodes || t >= g->num_nodes) continue;
+        double qt;
+        int settled;
+        exact[i] = run_p2p_query(g, s, t, heap_type, NULL, &qt, &settled, NULL, NULL);
+        exact_time += qt;
+        checked++;
+    }
+    if (checked == 0) {
+        fprintf(stderr, "No valid queries in %s\n", query_file);
+        free(exact);
+        free(queries);
+        return;
+    }
+
+    printf("\n=== Approximate Query Summary ===\n");
+    printf("Queries: %d, exact %s p2p: %.6f sec\n", checked, heap_type, exact_time);
+    if (rule == APPROX_WIDTH_MEAN)
+        printf("Width w_min + eps * w_mean: heuristic, the (1+eps) bound is not guaranteed\n");
+    printf("%-8s %-10s %-10s %-12s %-9s %-12s %-12s %-9s %s\n", "eps", "width", "Bound", "Total(s)",
+           "Speedup", "Mean err", "Max err", "Inexact", "Bound broken");
+
+    // 2. One approximate run per eps
+    char *list = malloc(strlen(eps_list) + 1);
+    strcpy(list, eps_list);
+    for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ",")) {
+        double eps = atof(tok);
+        double t0 = timer_now();
+        ApproxSearch *a = approx_create(g, eps, rule);
+        double sum_err = 0, max_err = 0;
+        int inexact = 0, broken = 0;
+        for (int i = 0; i < n; i++) {
+            if (exact[i] < 0) continue;
+            double d = approx_query(a, queries[i * 2], queries[i * 2 + 1], NULL);
+            if (d == exact[i]) continue;
+            inexact++;
+            double err = (exact[i] > 0 && d < DBL_MAX) ? (d - exact[i]) / exact[i] : DBL_MAX;
+            if (d < exact[i] || err > a->eps * (1 + 1e-12)) broken++;
+            if (err < DBL_MAX) sum_err += err;
+            if (err > max_err) max_err = err;
+        }
+        double total = timer_now() - t0;
+
+        printf("%-8g %-10g %-10g %-12.6f %-9.2f %-12.3e %-12.3e %-9d %d\n", a->eps, a->width, a->bound, total,
+               total > 0 ? exact_time / total : 0.0, sum_err / checked, max_err, inexact, broken);
+        approx_free(a);
+    }
+
+    free(list);
+    free(exact);
+    free(queries);
+}
+
+// Number of budgets swept by "range" when none are given.
+#define RANGE_AUTO_BUDGETS 5
+
+/**
+ * Runs the bounded-range (isochrone) benchmark.
+ *
+ * For 'num_sources' random sources, runs one full SSSP with 'heap_type'
+ * (the only option before range queries existed) and one range query
+ * per budget on a shared workspace, with boundary arcs. Every range is
+ * checked against the full SSSP: same node set, same distances.
+ * 'budget_list' is a comma-separated list of budgets; if NULL, budgets
+ * are 1/256, 1/64, 1/16, 1/4 and 1 times the eccentricity of the first
+ * source.
+ */
+void run_range_test(const Graph *g, const char *heap_type, int num_sources,
+                    const char *budget_list, int seed) {
+    int n = g->num_nodes;
+    RangeSearch *r = range_create(g, heap_type);
+    if (!r) {
+        fprintf(stderr, "Range mode supports fib and pair, not %s\n", heap_type);
+        return;
+    }
+    if (num_sources < 1) num_sources = 1;
+    srand(seed);
+    int *sources = malloc(num_sources * sizeof(int));
+    for (int i = 0; i < num_sources; i++) sources[i] = rand() % n;
+
+    // Budgets: given, or scaled to the eccentricity of the first source
+    int num_budgets = 0;
+    double *budgets = NULL;
+    if (budget_list) {
+        char *list = malloc(strlen(budget_list) + 1);
+        strcpy(list, budget_list);
+        budgets = malloc((strlen(budget_list) / 2 + 1) * sizeof(double));
+        for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ","))
+            budgets[num_budgets++] = atof(tok);
+        free(list);
+    } else {
+        double *dist = run_sssp(g, sources[0], heap_type);
+        double ecc = 0;
+        for (int v = 0; v < n; v++)
+            if (dist[v] < DBL_MAX && dist[v] > ecc) ecc = dist[v];
+        free(dist);
+        budgets = malloc(RANGE_AUTO_BUDGETS * sizeof(double));
+        for (int k = 0; k < RANGE_AUTO_BUDGETS; k++)
+            budgets[num_budgets++] = ecc / (double)(1 << (2 * (RANGE_AUTO_BUDGETS - 1 - k)));
+    }
+
+    double *range_time = calloc(num_budgets, sizeof(double));
+    long *in_range = calloc(num_budgets, sizeof(long));
+    long *boundary = calloc(num_budgets, sizeof(long));
+    int *mismatches = calloc(num_budgets, sizeof(int));
+    double full_time = 0;
+
+    for (int i = 0; i < num_sources; i++) {
+        int s = sources[i];
+        double t0 = timer_now();
+        double *ref = run_sssp(g, s, heap_type);
+        full_time += timer_now() - t0;
+
+        for (int k = 0; k < num_budgets; k++) {
+            t0 = timer_now();
+            int found = range_query(r, s, budgets[k], 1);
+            range_time[k] += timer_now() - t0;
+            in_range[k] += found;
+            boundary[k] += r->num_boundary;
+
+            // Same node set and distances as the full SSSP
+            int expected = 0;
+            for (int v = 0; v < n; v++) expected += (ref[v] <= budgets[k]);
+            int bad = (found != expected);
+            for (int j = 0; j < found && !bad; j++) {
+                int v = r->nodes[j];
+                bad = (r->dist[v] != ref[v]) || (j > 0 && r->dist[v] < r->dist[r->nodes[j - 1]]);
+            }
+            mismatches[k] += bad;
+        }
+        free(ref);
+    }
+
+    printf("\n=== Range Query Summary ===\n");
+    printf("Sources: %d, heap: %s, full SSSP avg: %.6f sec\n",
+           num_sources, heap_type, full_time / num_sources);
+    printf("%-14s %-12s %-12s %-12s %-9s %s\n", "Budget", "Avg nodes", "Avg bound.",
+           "Avg time(s)", "Speedup", "Mismatches");
+    for (int k = 0; k < num_budgets; k++) {
+        printf("%-14.1f %-12.1f %-12.1f %-12.6f %-9.2f %d\n", budgets[k],
+               (double)in_range[k] / num_sources, (double)boundary[k] / num_sources,
+               range_time[k] / num_sources,
+               range_time[k] > 0 ? full_time / range_time[k] : 0.0, mismatches[k]);
+    }
+
+    free(range_time);
+    free(in_range);
+    free(boundary);
+    free(mismatches);
+    free(budgets);
+    free(sources);
+    range_free(r);
+}
+
+/**
+ * Runs the incremental SSSP benchmark.
+ *
+ * For each of 'num_sources' random sources, builds a dynamic SSSP and
+ * applies batches of 1, 10, 100, ... up to 'max_batch' random weight
+ * changes (half increases up to 3x, half decreases down to 0.5x, integer
+ * weights). After every batch the repaired distances are compared with
+ * a full 'heap_type' SSSP on the updated graph, and the tree parents are
+ * checked to lie on shortest paths. The graph's weights are modified.
+ */
+void run_dynamic_test(Graph *g, const char *heap_type, int num_sources, int max_batch, int seed) {
+    int n = g->num_nodes;
+    if (num_sources < 1) num_sources = 1;
+    if (max_batch < 1) max_batch = 1;
+    srand(seed);
+
+    printf("Incremental SSSP mode\n");
+    printf("Sources = %d, batches 1 .. %d, baseline = %s\n", num_sources, max_batch, heap_type);
+
+    int num_sizes = 0;
+    for (long b = 1; b <= max_batch; b *= 10) num_sizes++;
+    double *repair_time = calloc(num_sizes, sizeof(double));
+    double *full_time = calloc(num_sizes, sizeof(double));
+    long *repaired = calloc(num_sizes, sizeof(long));
+    int *mismatches = calloc(num_sizes, sizeof(int));
+    WeightChange *batch = malloc(max_batch * sizeof(WeightChange));
+
+    for (int i = 0; i < num_sources; i++) {
+        DynamicSSSP *d = dyn_create(g, rand() % n);
+
+        int k = 0;
+        for (long size = 1; size <= max_batch; size *= 10, k++) {
+            // Random arcs, found through a random tail with out-arcs
+            for (int j = 0; j < size; j++) {
+                int u;
+                do { u = rand() % n; } while (!g->adj[u]);
+                int deg = 0;
+                for (Edge *e = g->adj[u]; e; e = e->next) deg++;
+                Edge *e = g->adj[u];
+                for (int r = rand() % deg; r > 0; r--) e = e->next;
+
+                double factor = (rand() & 1) ? 1.0 + 2.0 * rand() / RAND_MAX
+                                             : 0.5 + 0.5 * rand() / RAND_MAX;
+                double w = (double)(long)(e->weight * factor);
+                batch[j].u = u;
+                batch[j].v = e->to;
+                batch[j].weight = w < 1 ? 1 : w;
+            }
+
+            double t0 = timer_now();
+            repaired[k] += dyn_update(d, batch, (int)size);
+            repair_time[k] += timer_now() - t0;
+
+            t0 = timer_now();
+            double *ref = run_sssp(g, d->source, heap_type);
+            full_time[k] += timer_now() - t0;
+            if (!ref) {
+                fprintf(stderr, "Unknown heap type: %s\n", heap_type);
+                exit(EXIT_FAILURE);
+            }
+
+            int bad = 0;
+            for (int v = 0; v < n && !bad; v++) {
+                if (d->dist[v] != ref[v]) bad = 1;
+                int p = d->parent[v];
+                if (p < 0) {
+                    bad |= (v != d->source && ref[v] < DBL_MAX);
+                    continue;
+                }
+                int on_path = 0;
+                for (Edge *e = g->adj[p]; e && !on_path; e = e->next)
+                    on_path = (e->to == v && d->dist[p] + e->weight == d->dist[v]);
+                bad |= !on_path;
+            }
+            mismatches[k] += bad;
+            free(ref);
+        }
+        dyn_free(d);
+    }
+
+    printf("\n=== Incremental SSSP Summary ===\n");
+    printf("%-10s %-14s %-14s %-14s %-9s %s\n", "Batch", "Repair avg(s)", "Settled avg",
+           "Full avg(s)", "Speedup", "Mismatches");
+    long size = 1;
+    for (int k = 0; k < num_sizes; k++, size *= 10) {
+        printf("%-10ld %-14.6f %-14.1f %-14.6f %-9.2f %d\n", size,
+               repair_time[k] / num_sources, (double)repaired[k] / num_sources,
+               full_time[k] / num_sources,
+               repair_time[k] > 0 ? full_time[k] / repair_time[k] : 0.0, mismatches[k]);
+    }
+
+    free(batch);
+    free(repair_time);
+    free(full_time);
+    free(repaired);
+    free(mismatches);
+}
+
+/**
+ * Measures how parallel delta-stepping scales with the thread count.
+ *
+ * Runs one SSSP from a random source with 'heap_type' as the sequential
+ * baseline, then delta-stepping with 1, 2, 4, ... up to 'max_threads'
+ * threads. Every result is checked against the baseline distances.
+ */
+void run_delta_scaling(const Graph *g, const char *heap_type, int max_threads, double delta, int seed) {
+    srand(seed);
+    int s = rand() % g->num_nodes;
+    printf("Delta-stepping scaling mode\n");
+    printf("Source = %d, baseline = %s\n", s + 1, heap_type);
+
+    double t0 = timer_now();
+    double *ref = run_sssp(g, s, heap_type);
+    if (!ref) {
+        fprintf(stderr, "Unknown heap type: %s\n", heap_type);
+        return;
+    }
+    double base_time = timer_now() - t0;
+    printf("%s baseline: %.6f sec\n\n", heap_type, base_time);
+
+    printf("%-8s %-12s %-14s %-14s %-10s %s\n",
+           "Threads", "Time(s)", "vs baseline", "vs 1 thread", "Effic.", "Mismatches");
+    double one_thread = 0;
+    for (int threads = 1; threads <= max_threads; ) {
+        t0 = timer_now();
+        double *dist = dijkstra_delta(g, s, delta, threads);
+        double t = timer_now() - t0;
+        if (threads == 1) one_thread = t;
+
+        int mismatches = 0;
+        for (int v = 0; v < g->num_nodes; v++) {
+            double diff = dist[v] - ref[v];
+            if (ref[v] == DBL_MAX ? dist[v] != DBL_MAX : (diff > 1e-9 * ref[v] || diff < -1e-9 * ref[v]))
+                mismatches++;
+        }
+
+        double self = (t > 0) ? one_thread / t : 0;
+        printf("%-8d %-12.6f %-14.2f %-14.2f %-10.2f %d\n",
+               threads, t, (t > 0) ? base_time / t : 0, self, self / threads, mismatches);
+        free(dist);
+
+        // Double each step, but always finish with max_threads itself
+        if (threads == max_threads) break;
+        threads = (threads * 2 > max_threads) ? max_threads : threads * 2;
+    }
+
+    free(ref);
+}
+
+/**
+ * Compares the multi-source engine with the sequential kernels.
+ *
+ * 'num_sources' random sources are processed in groups of MS_LANES:
+ * each group runs once through dijkstra_multi and once as separate
+ * 'heap_type' SSSPs, and the two results are compared. With 'clustered'
+ * set, each group is a random node plus its BFS neighbours (e.g. the
+ * depots of one region), where the lanes settle nearly together.
+ */
+void run_multi_source(const Graph *g, const char *heap_type, int num_sources, int clustered, int seed) {
+    int n = g->num_nodes;
+    if (num_sources < 1) num_sources = 1;
+    srand(seed);
+
+    printf("Multi-source batched Dijkstra mode\n");
+    printf("Sources = %d (%s), lanes = %d, baseline = %s\n",
+           num_sources, clustered ? "clustered" : "random", MS_LANES, heap_type);
+
+    double *rows[MS_LANES];
+    for (int i = 0; i < MS_LANES; i++) rows[i] = malloc(n * sizeof(double));
+
+    double multi_time = 0, seq_time = 0;
+    long scans = 0;
+    int mismatches = 0;
+
+    for (int done = 0; done < num_sources; ) {
+        int k = num_sources - done < MS_LANES ? num_sources - done : MS_LANES;
+        int src[MS_LANES];
+        if (clustered) {
+            // One random root and its nearest nodes in BFS order
+            src[0] = rand() % n;
+            int found = 1;
+            for (int h = 0; h < found && found < k; h++) {
+                for (Edge *e = g->adj[src[h]]; e && found < k; e = e->next) {
+                    int dup = 0;
+                    for (int j = 0; j < found; j++) dup |= (src[j] == e->to);
+                    if (!dup) src[found++] = e->to;
+                }
+            }
+            for (int i = found; i < k; i++) src[i] = rand() % n;
+        } else {
+            for (int i = 0; i < k; i++) src[i] = rand() % n;
+        }
+
+        double t0 = timer_now();
+        scans += dijkstra_multi(g, src, k, rows);
+        multi_time += timer_now() - t0;
+
+        for (int i = 0; i < k; i++) {
+            t0 = timer_now();
+            double *ref = run_sssp(g, src[i], heap_type);
+            seq_time += timer_now() - t0;
+            if (!ref) {
+                fprintf(stderr, "Unknown heap type: %s\n", heap_type);
+                for (int j = 0; j < MS_LANES; j++) free(rows[j]);
+                return;
+            }
+            for (int v = 0; v < n; v++)
+                if (rows[i][v] != ref[v]) mismatches++;
+            free(ref);
+        }
+        done += k;
+    }
+
+    printf("Sequential %s: %.6f sec, %.2f SSSPs/sec\n",
+           heap_type, seq_time, seq_time > 0 ? num_sources / seq_time : 0.0);
+    printf("Multi-source:  %.6f sec, %.2f SSSPs/sec\n",
+           multi_time, multi_time > 0 ? num_sources / multi_time : 0.0);
+    printf("Speedup: %.2fx, node scans per batch: %.1f (%.2f x n), mismatches: %d\n",
+           multi_time > 0 ? seq_time / multi_time : 0.0,
+           (double)scans / ((num_sources + MS_LANES - 1) / MS_LANES),
+           (double)scans / ((num_sources + MS_LANES - 1) / MS_LANES) / n, mismatches);
+
+    for (int i = 0; i < MS_LANES; i++) free(rows[i]);
+}
+
+/**
+ * Scaling sweep: for n = 10^min_exp .. 10^max_exp generates the graph
+ * 'base' describes with n nodes and times full SSSPs from 'sources'
+ * random sources (with at least one arc) with each heap ("all" = fib
+ * and pair, run back to back per source). Sizes whose estimated memory
+ * exceeds 3/4 of physical memory are skipped. Prints one row per size
+ * and heap and writes them to result/sweep/<kind>.csv (kept out of
+ * result/ itself, where compare_runs looks for run logs).
+ */
+void run_sweep(const SynthParams *base, const char *heap_type, int min_exp, int max_exp, int sources) {
+    static const char *all_heaps[] = { "fib", "pair" };
+    const char **heaps = all_heaps;
+    int num_heaps = 2;
+    if (strcmp(heap_type, "all") != 0) {
+        heaps = &heap_type;
+        num_heaps = 1;
+    }
+    if (sources < 1) sources = 1;
+    if (max_exp > 9) max_exp = 9; // Node ids are ints
+    long long phys = mem_physical_bytes();
+
+    char path[256];
+    snprintf(path, sizeof(path), "result/sweep/%s.csv", synth_kind_name(base->kind));
+    FILE *fcsv = fopen(path, "w");
+    if (fcsv) fprintf(fcsv, "kind,nodes,arcs,degree,seed,gen_s,heap,sources,avg_sssp_s,ns_per_node,peak_bytes\n");
+
+    printf("Scaling sweep: %s graphs, degree %g, seed %llu, %d sources per size\n",
+           synth_kind_name(base->kind), base->degree, base->seed, sources);
+    printf("%11s %12s %9s  %-5s %12s %10s %10s\n", "Nodes", "Arcs", "Gen(s)", "Heap",
+           "SSSP(ms)", "ns/node", "Peak(MB)");
+
+    // Sweeps run every search to completion
+    double saved_timeout = query_timeout;
+    long saved_settled = query_max_settled;
+    query_timeout = 0;
+    query_max_settled = 0;
+
+    for (int e = min_exp; e <= max_exp; e++) {
+        SynthParams p = *base;
+        p.n = (int)pow(10, e);
+        size_t need = synth_estimate_bytes(&p);
+        if (phys > 0 && need > phys / 4 * 3) {
+            printf("%11d   skipped: needs about %.1f GB, %.1f GB installed\n",
+                   p.n, need / 1e9, phys / 1e9);
+            continue;
+        }
+
+        double t0 = timer_now();
+        Graph *g = synth_generate(&p);
+        double gen_time = timer_now() - t0;
+
+        int *src = malloc(sources * sizeof(int));
+        synth_sources(g, sources, p.seed, src);
+
+        double total[2] = { 0, 0 };
+        long long peak[2] = { -1, -1 }; // Stays -1 for heaps that are not counted
+        for (int i = 0; i < sources; i++) {
+            for (int h = 0; h < num_heaps; h++) {
+                double time_used;
+                run_single_query(g, src[i], src[i], heaps[h], &time_used, NULL, NULL);
+                total[h] += time_used;
+                long long bytes = query_mem.peak + query_heap_mem.peak;
+                if (query_mem.allocs > 0 && bytes > peak[h]) peak[h] = bytes;
+            }
+        }
+
+        for (int h = 0; h < num_heaps; h++) {
+            double avg = total[h] / sources;
+            printf("%11d %12ld %9.3f  %-5s %12.3f %10.2f ", g->num_nodes, g->num_edges,
+                   gen_time, heaps[h], 1e3 * avg, 1e9 * avg / g->num_nodes);
+            if (peak[h] >= 0) printf("%10.2f\n", peak[h] / 1048576.0);
+            else printf("%10s\n", "-");
+            if (fcsv)
+                fprintf(fcsv, "%s,%d,%ld,%g,%llu,%.6f,%s,%d,%.9f,%.3f,%lld\n", synth_kind_name(p.kind),
+                        g->num_nodes, g->num_edges, p.degree, p.seed, gen_time, heaps[h], sources,
+                        avg, 1e9 * avg / g->num_nodes, peak[h]);
+        }
+        fflush(stdout);
+        free(src);
+        free_graph(g);
+    }
+
+    query_timeout = saved_timeout;
+    query_max_settled = saved_settled;
+    if (fcsv) {
+        fclose(fcsv);
+        printf("Results written to %s\n", path);
+    }
+}
+
+/**
+ * Applies the harness options argv[first..first+3]: warmup runs and
+ * timed repetitions per query, the CPU to pin to (-1 = none) and
+ * whether to pre-fault the query memory. Missing options keep the
+ * given defaults.
+ */
+static void apply_harness_options(const Graph *g, int argc, char *argv[], int first,
+                                  int warmup, int reps, int prefault) {
+    int cpu = -1;
+    if (argc > first) warmup = atoi(argv[first]);
+    if (argc > first + 1) reps = atoi(argv[first + 1]);
+    if (argc > first + 2) cpu = atoi(argv[first + 2]);
+    if (argc > first + 3) prefault = atoi(argv[first + 3]);
+
+    query_warmup = warmup > 0 ? warmup : 0;
+    query_reps = reps < 1 ? 1 : (reps > MAX_REPETITIONS ? MAX_REPETITIONS : reps);
+    if (cpu >= 0 && harness_pin_cpu(cpu)) printf("Pinned to CPU %d\n", cpu);
+    if (prefault) {
+        double t0 = timer_now();
+        harness_prefault(g, QUERY_BYTES_PER_NODE);
+        printf("Pre-faulted query memory in %.3f sec\n", timer_now() - t0);
+    }
+}
+
+/**
+ * Loads the SCC index saved next to the graph ("<graph_file>.scc"),
+ * building and saving it on first use, and prints a short summary.
+ */
+static void load_scc_index(const Graph *g, const char *graph_file) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s.scc", graph_file);
+
+    double t0 = timer_now();
+    scc_index = graph_is_synthetic ? scc_build(g) : scc_load_or_build(g, path);
+    printf("SCC index: %d components, largest %d nodes (%.2f%%), %.3f sec\n",
+           scc_index->num_comps, scc_index->giant_size,
+           g->num_nodes ? 100.0 * scc_index->giant_size / g->num_nodes : 0.0, timer_now() - t0);
+}
+
+// Prints the command-line usage instructions.
+void usage(const char *prog) {
+    printf("Usage:\n");
+    printf("  %s <graph_file> <query_file|random|query_dir> <heap_type> [options]\n", prog);
+    printf("heap_type: fib | pair | delta (parallel delta-stepping)\n");
+    printf("graph_file may also be a synthetic graph kind:n[:degree[:seed]], kind: grid | rgg | gnm | rmat\n");
+    printf("Examples:\n");
+    printf("  %s data/USA-road-d.USA.gr queries/q1.qry fib\n", prog);
+    printf("  %s data/USA-road-d.USA.gr random pair 1000 12345 1\n", prog);
+    printf("  %s data/USA-road-d.USA.gr random delta 1000 12345 0 [threads] [delta]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr query_dir fib\n", prog);
+    printf("Query file / query_dir options: [timeout_sec=10 (0 = none)] [max_settled=0 (none)] [perf=0|1]\n");
+    printf("  Aborted queries are written as \"s t TIMEOUT time\" (fib and pair only)\n");
+    printf("  perf=1 counts cycles, instructions, cache/TLB and branch misses per query (Linux)\n");
+    printf("  Each run is also logged to result/<query_file>_<heap>.csv and .json (host, build,\n");
+    printf("  phase times, counters); compare two runs with: compare_runs <base_dir> <new_dir>\n");
+    printf("  Harness options after perf: [warmup=0] [reps=1 (median reported)] [cpu=-1 (no pinning)] [prefault=0|1]\n");
+    printf("  %s data/USA-road-d.USA.gr queries/q1.qry fib 10 0 0 2 9 3 1\n", prog);
+    printf("\nCRP mode (multi-level overlay, heap_type is the verification baseline):\n");
+    printf("  %s <graph_file> crp <heap_type> <query_file> [levels] [base_cell_size] [threads] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr crp fib Queries/normal_queries_1000.txt 4 256 8\n", prog);
+    printf("\nDistance table mode (first N query endpoints as S x T, heap_type is the naive baseline):\n");
+    printf("  %s <graph_file> table <heap_type> <query_file> [max_endpoints] [naive_rows] [levels] [base_cell_size] [threads]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr table fib Queries/normal_queries_1000.txt 1000 50\n", prog);
+    printf("\nBatch mode (thread pool with work stealing, heap_type: fib | pair):\n");
+    printf("  %s <graph_file> batch <heap_type> <query_file> [threads]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr batch fib Queries/large_scale_queries_10000.txt 64\n", prog);
+    printf("\nGrouped mode (one search per distinct source, heap_type: fib | pair):\n");
+    printf("  %s <graph_file> grouped <heap_type> <query_file> [compare=1]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr grouped pair Queries/normal_queries_1000.txt\n", prog);
+    printf("\nMulti-source mode (%d SSSPs per traversal, heap_type is the sequential baseline):\n", MS_LANES);
+    printf("  %s <graph_file> multi <heap_type> [num_sources] [clustered] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr multi fib 64\n", prog);
+    printf("\nInterleaved mode (several p2p queries in flight on one core, heap_type is the baseline):\n");
+    printf("  %s <graph_file> interleave <heap_type> <query_file> [width]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr interleave fib Queries/normal_queries_1000.txt 8\n", prog);
+    printf("\nBidirectional mode (1-thread vs 2-thread, heap_type is the reference):\n");
+    printf("  %s <graph_file> bidi <heap_type> <query_file>\n", prog);
+    printf("  %s data/USA-road-d.USA.gr bidi fib Queries/normal_queries_1000.txt\n", prog);
+    printf("\nApproximate mode ((1+eps) bucket queue, heap_type is the exact reference):\n");
+    printf("  %s <graph_file> approx <heap_type> <query_file> [eps_list=0,0.01,0.05,0.1] [width=min|mean]\n", prog);
+    printf("  (width=mean scales buckets by the mean arc weight: faster, but no (1+eps) guarantee)\n");
+    printf("  %s data/USA-road-d.USA.gr approx fib Queries/normal_queries_1000.txt 0,0.01,0.1,1\n", prog);
+    printf("\nAlternate mode (fib and pair back to back per query, heap_type goes first on even queries):\n");
+    printf("  %s <graph_file> alternate <heap_type> <query_file> [warmup=1] [reps=5] [cpu=-1] [prefault=1]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr alternate fib Queries/normal_queries_1000.txt 1 5 2\n", prog);
+    printf("\nRange mode (isochrones for a sweep of budgets vs full SSSP, heap_type: fib | pair):\n");
+    printf("  %s <graph_file> range <heap_type> [num_sources] [budget_list|auto] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr range fib 20 10000,100000,1000000\n", prog);
+    printf("\nIncremental SSSP mode (repair after weight changes vs full SSSP with heap_type):\n");
+    printf("  %s <graph_file> dynamic <heap_type> [num_sources] [max_batch] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr dynamic fib 3 10000\n", prog);
+    printf("\nChain contraction mode (degree-2 chains collapsed, heap_type: fib | pair):\n");
+    printf("  %s <graph_file> contract <heap_type> [query_file|-] [num_sssp] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr contract fib Queries/normal_queries_1000.txt 5\n", prog);
+    printf("\nDelta-stepping scaling mode (heap_type is the sequential baseline):\n");
+    printf("  %s <graph_file> scale <heap_type> [max_threads] [delta] [seed]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr scale fib 64\n", prog);
+    printf("\nArc flags mode:\n");
+    printf("  %s <graph_file> arcflags <heap_type> <query_file> [regions] [threads]\n", prog);
+    printf("  %s data/USA-road-d.USA.gr arcflags fib Queries/normal_queries_1000.txt 64 8\n", prog);
+    printf("\nScaling sweep (synthetic graphs of 10^min_exp .. 10^max_exp nodes, heap_type: fib | pair | all):\n");
+    printf("  %s <grid|rgg|gnm|rmat> sweep <heap_type> [min_exp=4] [max_exp=8] [sources=5] [degree] [seed=1] [threads]\n", prog);
+    printf("  %s grid sweep all 4 7 10\n", prog);
+    printf("  %s rmat:1048576:16 random pair 1000 12345\n", prog);
+    printf("\nNote: Query time includes heap build + Dijkstra execution time\n");
+}
+
+/**
+ * Main entry point for the benchmark executable.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    const char *graph_file = argv[1];
+    graph_path = graph_file;
+    const char *heap_type = argv[3];
+
+    // Mode: "sweep" (generates its own graphs; argv[1] is the graph kind)
+    if (strcmp(argv[2], "sweep") == 0) {
+        SynthParams base;
+        int kind = -1;
+        for (int k = 0; k < SYNTH_NUM_KINDS; k++)
+            if (strcmp(graph_file, synth_kind_name(k)) == 0) kind = k;
+        if (kind < 0) {
+            fprintf(stderr, "Unknown graph kind %s\n", graph_file);
+            usage(argv[0]);
+            return -1;
+        }
+        synth_defaults((SynthKind)kind, 2, &base);
+        int min_exp = (argc >= 5) ? atoi(argv[4]) : 4;
+        int max_exp = (argc >= 6) ? atoi(argv[5]) : 8;
+        int sources = (argc >= 7) ? atoi(argv[6]) : 5;
+        if (argc >= 8) base.degree = atof(argv[7]);
+        if (argc >= 9) base.seed = strtoull(argv[8], NULL, 10);
+        if (argc >= 10) base.threads = atoi(argv[9]);
+        MKDIR("result");
+        MKDIR("result/sweep");
+        run_sweep(&base, heap_type, min_exp, max_exp, sources);
+        return 0;
+    }
+
+    // Generate the graph for a spec like "grid:1e6", or load it from file
+    SynthParams synth;
+    Graph *g;
+    if (synth_parse(graph_file, &synth)) {
+        double t0 = timer_now();
+        g = synth_generate(&synth);
+        graph_is_synthetic = 1;
+        printf("Graph generated: %s, %d nodes, %ld arcs, %.3f sec\n",
+               synth_kind_name(synth.kind), g->num_nodes, g->num_edges, timer_now() - t0);
+    } else {
+        if (!file_exists(graph_file)) {
+            fprintf(stderr, "Graph file not found\n");
+            return -1;
+        }
+        g = load_dimacs_graph(graph_file);
+        printf("Graph loaded: %d nodes\n", g->num_nodes);
+    }
+    printf("==========================================\n");
+
+    const char *q = argv[2]; // The mode/query file argument
+
+    // Mode 1: "random"
+    if (strcmp(q, "random") == 0) {
+        if (argc < 5) {
+            printf("Missing num_queries\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+
+        int n = atoi(argv[4]);
+        int seed = (argc >= 6) ? atoi(argv[5]) : (int)time(NULL);
+        int verbose = (argc >= 7) ? atoi(argv[6]) : 0;
+        delta_threads = (argc >= 8) ? atoi(argv[7]) : 0;
+        delta_width = (argc >= 9) ? atof(argv[8]) : 0;
+
+        run_random(g, n, seed, verbose, heap_type);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "crp"
+    if (strcmp(q, "crp") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+
+        int levels = (argc >= 6) ? atoi(argv[5]) : 4;
+        int base_cell = (argc >= 7) ? atoi(argv[6]) : 256;
+        int threads = (argc >= 8) ? atoi(argv[7]) : 0;
+        int seed = (argc >= 9) ? atoi(argv[8]) : 12345;
+
+        run_crp(g, argv[4], heap_type, levels, base_cell, threads, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "table"
+    if (strcmp(q, "table") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        MKDIR("result");
+        const char *qf = argv[4];
+        int max_endpoints = (argc >= 6) ? atoi(argv[5]) : 1000;
+        int naive_rows = (argc >= 7) ? atoi(argv[6]) : 100;
+        int levels = (argc >= 8) ? atoi(argv[7]) : 4;
+        int base_cell = (argc >= 9) ? atoi(argv[8]) : 256;
+        int threads = (argc >= 10) ? atoi(argv[9]) : 0;
+
+        const char *base = strrchr(qf, '/');
+        if (!base) base = strrchr(qf, '\\');
+        base = base ? base + 1 : qf;
+
+        char out[256];
+        snprintf(out, sizeof(out), "result/%s_table.bin", base);
+        run_table(g, qf, out, heap_type, max_endpoints, naive_rows, levels, base_cell, threads);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "batch"
+    if (strcmp(q, "batch") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        MKDIR("result");
+        const char *qf = argv[4];
+        int threads = (argc >= 6) ? atoi(argv[5]) : 0;
+
+        const char *base = strrchr(qf, '/');
+        if (!base) base = strrchr(qf, '\\');
+        base = base ? base + 1 : qf;
+
+        char out[256];
+        snprintf(out, sizeof(out), "result/%s_batch_result.txt", base);
+        run_batch_test(g, qf, out, heap_type, threads);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "grouped"
+    if (strcmp(q, "grouped") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        MKDIR("result");
+        const char *qf = argv[4];
+        int compare = (argc >= 6) ? atoi(argv[5]) : 1;
+
+        const char *base = strrchr(qf, '/');
+        if (!base) base = strrchr(qf, '\\');
+        base = base ? base + 1 : qf;
+
+        char out[256];
+        snprintf(out, sizeof(out), "result/%s_grouped_result.txt", base);
+        run_grouped_test(g, qf, out, heap_type, compare);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "interleave"
+    if (strcmp(q, "interleave") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        MKDIR("result");
+        const char *qf = argv[4];
+        int width = (argc >= 6) ? atoi(argv[5]) : 8;
+
+        const char *base = strrchr(qf, '/');
+        if (!base) base = strrchr(qf, '\\');
+        base = base ? base + 1 : qf;
+
+        char out[256];
+        snprintf(out, sizeof(out), "result/%s_interleaved_result.txt", base);
+        run_interleave_test(g, qf, out, heap_type, width);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "bidi"
+    if (strcmp(q, "bidi") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+
+        run_bidi_test(g, argv[4], heap_type);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "approx"
+    if (strcmp(q, "approx") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        const char *eps_list = (argc >= 6) ? argv[5] : "0,0.01,0.05,0.1";
+        ApproxWidth rule = APPROX_WIDTH_MIN;
+        if (argc >= 7) {
+            if (strcmp(argv[6], "mean") == 0) rule = APPROX_WIDTH_MEAN;
+            else if (strcmp(argv[6], "min") != 0) {
+                printf("Unknown width rule: %s (use min or mean)\n", argv[6]);
+                free_graph(g);
+                return -1;
+            }
+        }
+
+        run_approx_test(g, argv[4], heap_type, eps_list, rule);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "alternate" (fib and pair back to back on every query)
+    if (strcmp(q, "alternate") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+        apply_harness_options(g, argc, argv, 5, 1, 5, 1);
+        MKDIR("result");
+        const char *base = strrchr(argv[4], '/');
+        if (!base) base = strrchr(argv[4], '\\');
+        base = base ? base + 1 : argv[4];
+        char out[512];
+        snprintf(out, sizeof(out), "result/%s_alternate.txt", base);
+        run_alternate_test(g, argv[4], out, heap_type);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "range"
+    if (strcmp(q, "range") == 0) {
+        int num_sources = (argc >= 5) ? atoi(argv[4]) : 20;
+        const char *budgets = (argc >= 6 && strcmp(argv[5], "auto") != 0) ? argv[5] : NULL;
+        int seed = (argc >= 7) ? atoi(argv[6]) : (int)time(NULL);
+
+        run_range_test(g, heap_type, num_sources, budgets, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "dynamic"
+    if (strcmp(q, "dynamic") == 0) {
+        int num_sources = (argc >= 5) ? atoi(argv[4]) : 3;
+        int max_batch = (argc >= 6) ? atoi(argv[5]) : 10000;
+        int seed = (argc >= 7) ? atoi(argv[6]) : (int)time(NULL);
+
+        run_dynamic_test(g, heap_type, num_sources, max_batch, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "contract"
+    if (strcmp(q, "contract") == 0) {
+        const char *qf = (argc >= 5 && strcmp(argv[4], "-") != 0) ? argv[4] : NULL;
+        int num_sssp = (argc >= 6) ? atoi(argv[5]) : 5;
+        int seed = (argc >= 7) ? atoi(argv[6]) : (int)time(NULL);
+
+        run_contract(g, qf, heap_type, num_sssp, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "multi"
+    if (strcmp(q, "multi") == 0) {
+        int num_sources = (argc >= 5) ? atoi(argv[4]) : 64;
+        int clustered = (argc >= 6) ? atoi(argv[5]) : 0;
+        int seed = (argc >= 7) ? atoi(argv[6]) : (int)time(NULL);
+
+        run_multi_source(g, heap_type, num_sources, clustered, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "scale"
+    if (strcmp(q, "scale") == 0) {
+        int max_threads = (argc >= 5) ? atoi(argv[4]) : 0;
+        double delta = (argc >= 6) ? atof(argv[5]) : 0;
+        int seed = (argc >= 7) ? atoi(argv[6]) : (int)time(NULL);
+#ifdef _OPENMP
+        if (max_threads <= 0) max_threads = omp_get_num_procs();
+#else
+        if (max_threads <= 0) max_threads = 1;
+#endif
+
+        run_delta_scaling(g, heap_type, max_threads, delta, seed);
+        free_graph(g);
+        return 0;
+    }
+
+    // Mode: "arcflags"
+    if (strcmp(q, "arcflags") == 0) {
+        if (argc < 5) {
+            printf("Missing query_file\n");
+            usage(argv[0]);
+            free_graph(g);
+            return -1;
+        }
+
+        int regions = (argc >= 6) ? atoi(argv[5]) : 64;
+        int threads = (argc >= 7) ? atoi(argv[6]) : 0;
+
+        run_arcflags(g, argv[4], heap_type, regions, threads);
+        free_graph(g);
+        return 0;
+    }
+
+    // Per-query limits for modes 2 and 3
+    if (argc >= 5) query_timeout = atof(argv[4]);
+    if (argc >= 6) query_max_settled = atol(argv[5]);
+    if (argc >= 7 && atoi(argv[6])) perf_group = perf_open();
+    apply_harness_options(g, argc, argv, 7, 0, 1, 0);
 
     // Mode 2: Directory
     // If 'q' is a directory, run tests on all .qry files inside it.
     if (is_directory(q)) {
         MKDIR("result"); // Ensure the result directory exists
+        load_scc_index(g, graph_file);
 
 #ifdef _WIN32
         // Windows directory scanning
@@ -291,6 +2549,8 @@ int main(int argc, char *argv[]) {
         }
         closedir(dir);
 #endif
+        free_scc_index(scc_index);
+        perf_close(perf_group);
         free_graph(g);
         return 0;
     }
@@ -298,6 +2558,7 @@ int main(int argc, char *argv[]) {
     // Mode 3: Single query file
     if (file_exists(q)) {
         MKDIR("result");
+        load_scc_index(g, graph_file);
         // Find the base filename (e.g., "q1.qry" from "queries/q1.qry")
         const char *base = strrchr(q, '/');
         if (!base) base = strrchr(q, '\\');
@@ -307,6 +2568,8 @@ int main(int argc, char *argv[]) {
         char out[256];
         sprintf(out, "result/%s_result.txt", base);
         run_query_test(g, q, out, heap_type);
+        free_scc_index(scc_index);
+        perf_close(perf_group);
         free_graph(g);
         return 0;
     }
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include "memtrack.h"
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2   // GetProcessMemoryInfo from kernel32, no -lpsapi
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Reports a failed allocation of 'size' bytes and exits.
+static void alloc_failed(size_t size) {
+    fprintf(stderr, "Error: allocation of %zu bytes failed.\n", size);
+    exit(EXIT_FAILURE);
+}
+
+void* xmalloc(size_t size) {
+    void *p = malloc(size);
+    if (!p && size > 0) alloc_failed(size);
+    return p;
+}
+
+void* xcalloc(size_t n, size_t size) {
+    void *p = calloc(n, size);
+    if (!p && n > 0 && size > 0) alloc_failed(n * size);
+    return p;
+}
+
+void* xrealloc(void *p, size_t size) {
+    void *q = realloc(p, size);
+    if (!q && size > 0) alloc_failed(size);
+    return q;
+}
+
+long mem_peak_rss_kb(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return -1;
+    return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+#ifdef __linux__
+    // VmHWM honours mem_reset_peak_rss, ru_maxrss does not
+    FILE *f = fopen("/proc/self/status", "r");
+    if (f) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), f))
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                kb = atol(line + 6);
+                break;
+            }
+        fclose(f);
+        if (kb >= 0) return kb;
+    }
+#endif
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024; // Bytes on macOS
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+}
+
+long long mem_physical_bytes(void) {
+#ifdef _WIN32
+    MEMORYSTATUSEX ms;
+    ms.dwLength = sizeof(ms);
+    return GlobalMemoryStatusEx(&ms) ? (long long)ms.ullTotalPhys : 0;
+#elif defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    long pages = sysconf(_SC_PHYS_PAGES), page = sysconf(_SC_PAGESIZE);
+    return (pages > 0 && page > 0) ? (long long)pages * page : 0;
+#else
+    return 0;
+#endif
+}
+
+int mem_reset_peak_rss(void) {
+#ifdef __linux__
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return 0;
+    int ok = fputs("5", f) >= 0;
+    return (fclose(f) == 0) && ok;
+#else
+    return 0;
+#endif
+}
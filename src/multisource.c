@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "multisource.h"
+#include "pairingheap.h"
+
+#ifdef _WIN32
+#include <malloc.h>       // _aligned_malloc (MinGW's CRT has no aligned_alloc)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MS_SIMD 1
+typedef double LaneVec __attribute__((vector_size(MS_LANES * sizeof(double))));
+typedef long long LaneMask __attribute__((vector_size(MS_LANES * sizeof(long long))));
+#define LANE(x, i) ((x)[i])
+#else
+typedef struct { double v[MS_LANES]; } LaneVec;
+#define LANE(x, i) ((x).v[i])
+#endif
+
+/**
+ * dst = min(dst, src + w) in every lane. Returns the smallest lane value
+ * that improved, or DBL_MAX if no lane improved.
+ */
+static inline double lane_relax(LaneVec *dst, const LaneVec *src, double w) {
+    double key = DBL_MAX;
+#ifdef MS_SIMD
+    LaneVec cand = *src + w;
+    LaneMask better = cand < *dst;
+    *dst = (LaneVec)(((LaneMask)cand & better) | ((LaneMask)*dst & ~better));
+
+    // Horizontal min over the improved lanes only
+    for (int i = 0; i < MS_LANES; i++)
+        if (better[i] && cand[i] < key) key = cand[i];
+#else
+    for (int i = 0; i < MS_LANES; i++) {
+        double c = src->v[i] + w;
+        if (c < dst->v[i]) {
+            dst->v[i] = c;
+            if (c < key) key = c;
+        }
+    }
+#endif
+    return key;
+}
+
+/**
+ * Allocates 'n' LaneVecs with the alignment vector loads need (plain
+ * malloc without SIMD). Free with lane_free.
+ */
+static LaneVec* lane_alloc(int n) {
+    size_t bytes = (size_t)n * sizeof(LaneVec);
+#if !defined(MS_SIMD)
+    return malloc(bytes);
+#elif defined(_WIN32)
+    return _aligned_malloc(bytes, sizeof(LaneVec));
+#else
+    return aligned_alloc(sizeof(LaneVec), bytes);
+#endif
+}
+
+static void lane_free(LaneVec *p) {
+#if defined(MS_SIMD) && defined(_WIN32)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+long dijkstra_multi(const Graph *g, const int *sources, int k, double **dist) {
+    int n = g->num_nodes;
+    if (k < 1 || k > MS_LANES) return 0;
+
+    LaneVec *D = lane_alloc(n);
+    if (!D) {
+        fprintf(stderr, "Error: multi-source distance allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++)
+        for (int i = 0; i < MS_LANES; i++) LANE(D[v], i) = DBL_MAX;
+
+    PairingHeap *H = pair_create(n);
+    for (int i = 0; i < k; i++) {
+        int s = sources[i];
+        if (s < 0 || s >= n) continue;
+        LANE(D[s], i) = 0.0;
+        pair_decrease_key(H, s, 0.0);
+    }
+
+    long scans = 0;
+    while (H->root) {
+        int u = pair_extract_min(H);
+        if (u == -1) break;
+        scans++;
+
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            double key = lane_relax(&D[e->to], &D[u], e->weight);
+            // Ignored by the heap if e->to is already queued with a smaller key
+            if (key < DBL_MAX) pair_decrease_key(H, e->to, key);
+        }
+    }
+
+    for (int v = 0; v < n; v++)
+        for (int i = 0; i < k; i++) dist[i][v] = LANE(D[v], i);
+
+    pair_free(H);
+    lane_free(D);
+    return scans;
+}
@@ -1,15 +1,16 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "pairingheap.h"
 
 // --- Static Helper Function Prototypes ---
 
-// Recursively frees a node and its entire subtree
-static void free_pair_node(PairNode *node);
+// Frees a node, its subtree and its following siblings, clearing their map slots
+static void free_pair_node(PairingHeap *h, PairNode *node);
 // Merges two heap trees, returning the new root
 static PairNode *pair_merge(PairNode *a, PairNode *b);
 // Combines a list of sibling nodes using a multi-pass strategy
-static PairNode *pair_combine(PairNode *first);
+static PairNode *pair_combine(PairingHeap *h, PairNode *first);
 
 
 // --- Helper Function Implementations ---
@@ -52,12 +53,12 @@ static PairNode *pair_merge(PairNode *a, PairNode *b) {
  * 2. Subsequent passes: Merges the resulting trees from right-to-left
  * until only one tree remains.
  */
-static PairNode *pair_combine(PairNode *first) {
+static PairNode *pair_combine(PairingHeap *h, PairNode *first) {
     if (!first) return NULL;
 
     // Use a dynamic array to store the merged sub-heaps from the first pass
     int cap = 128, n = 0;
-    PairNode **arr = malloc(cap * sizeof(PairNode*));
+    PairNode **arr = mem_malloc(&h->mem, cap * sizeof(PairNode*));
     if (!arr) return NULL; // Allocation failure
 
     PairNode *current = first;
@@ -78,7 +79,7 @@ static PairNode *pair_combine(PairNode *first) {
         // Resize array if needed
         if (n >= cap) {
             cap *= 2;
-            arr = realloc(arr, cap * sizeof(PairNode*));
+            arr = mem_realloc(&h->mem, arr, (cap / 2) * sizeof(PairNode*), cap * sizeof(PairNode*));
             if (!arr) return NULL; // Realloc failure
         }
         
@@ -105,26 +106,32 @@ static PairNode *pair_combine(PairNode *first) {
     }
 
     PairNode *result = (n > 0) ? arr[0] : NULL;
-    free(arr);
+    mem_free(&h->mem, arr, cap * sizeof(PairNode*));
     return result;
 }
 
 /**
- * Recursively frees a node, its children, and its siblings.
+ * Frees a node, its children, and its siblings, and clears their map
+ * entries. Iterative, so an aborted search with a long sibling list
+ * cannot overflow the stack.
  */
-static void free_pair_node(PairNode *node) {
-    if (!node) return;
-    
-    // We must traverse recursively, not just follow siblings,
-    // as free(node) invalidates access to node->sibling.
-    PairNode *child = node->child;
-    PairNode *sibling = node->sibling;
-    
-    free(node); // Free current node first
-    
-    // Then free the sub-lists
-    if (child) free_pair_node(child);
-    if (sibling) free_pair_node(sibling);
+static void free_pair_node(PairingHeap *h, PairNode *node) {
+    // Viewing 'child' as the left and 'sibling' as the right pointer,
+    // each rotation moves one node onto the sibling spine, where it is
+    // freed once it has no children left: O(n) total.
+    while (node) {
+        if (node->child) {
+            PairNode *c = node->child;
+            node->child = c->sibling;
+            c->sibling = node;
+            node = c;
+        } else {
+            PairNode *next = node->sibling;
+            h->map[node->value] = NULL;
+            mem_free_object(&h->mem, node, sizeof(PairNode));
+            node = next;
+        }
+    }
 }
 
 
@@ -136,9 +143,13 @@ PairingHeap *pair_create(int n) {
     
     h->root = NULL;
     h->n = n;
+#ifdef HEAP_STATS
+    memset(&h->stats, 0, sizeof(HeapStats));
+#endif
     
     // Allocate the map for O(1) node access
-    h->map = calloc(n, sizeof(PairNode *));
+    mem_init(&h->mem);
+    h->map = mem_calloc(&h->mem, n, sizeof(PairNode *));
     if (!h->map) {
         free(h);
         return NULL;
@@ -156,7 +167,7 @@ void pair_insert(PairingHeap *h, double key, int val) {
     }
 
     // Create the new node
-    PairNode *node = malloc(sizeof(PairNode));
+    PairNode *node = mem_new_object(&h->mem, sizeof(PairNode));
     if (!node) return; // Allocation failure
     
     node->key = key;
@@ -167,6 +178,7 @@ void pair_insert(PairingHeap *h, double key, int val) {
     node->prev = NULL;
 
     // Merge the new node with the root
+    HEAP_STAT(h->stats.inserts++; if (h->root) h->stats.links++);
     h->root = pair_merge(h->root, node);
     
     // Store in map
@@ -184,15 +196,25 @@ int pair_extract_min(PairingHeap *h) {
     
     // Disconnect all children from the old root
     PairNode *child = first_child;
+#ifdef HEAP_STATS
+    long num_children = 0;
+#endif
     while (child) {
         child->parent = NULL;
         child = child->sibling;
+        HEAP_STAT(num_children++);
     }
+    // The children form the "root list"; combining k trees takes k - 1 links
+    HEAP_STAT(h->stats.extract_mins++;
+              h->stats.root_list_total += num_children;
+              if (num_children > h->stats.root_list_max) h->stats.root_list_max = num_children;
+              if (num_children > h->stats.max_degree) h->stats.max_degree = num_children;
+              if (num_children > 1) h->stats.links += num_children - 1);
 
     // Rebuild the heap by merging all children
-    h->root = pair_combine(first_child);
+    h->root = pair_combine(h, first_child);
     
-    free(old_root);
+    mem_free_object(&h->mem, old_root, sizeof(PairNode));
     return v;
 }
 
@@ -206,7 +228,11 @@ void pair_decrease_key(PairingHeap *h, int val, double newKey) {
         return;
     }
 
-    if (newKey >= x->key) return; // Not a valid decrease-key
+    if (newKey >= x->key) {
+        HEAP_STAT(h->stats.decrease_noops++);
+        return; // Not a valid decrease-key
+    }
+    HEAP_STAT(h->stats.decrease_keys++);
     
     x->key = newKey;
 
@@ -233,19 +259,43 @@ void pair_decrease_key(PairingHeap *h, int val, double newKey) {
     }
 
     // Reset x's pointers and merge it with the root
+    HEAP_STAT(h->stats.cuts++; h->stats.links++);
     x->parent = NULL;
     x->sibling = NULL;
     x->prev = NULL;
     h->root = pair_merge(h->root, x);
 }
 
+int pair_take_stats(PairingHeap *h, HeapStats *out) {
+#ifdef HEAP_STATS
+    *out = h->stats;
+    memset(&h->stats, 0, sizeof(HeapStats));
+    return 1;
+#else
+    (void)h;
+    memset(out, 0, sizeof(HeapStats));
+    return 0;
+#endif
+}
+
+void pair_clear(PairingHeap *h) {
+    if (!h || !h->root) return;
+
+    free_pair_node(h, h->root);
+    h->root = NULL;
+}
+
+void pair_memory(PairingHeap *h, MemCounter *out) {
+    *out = h->mem;
+}
+
 void pair_free(PairingHeap *h) {
     if (!h) return;
     
-    // Recursively free all nodes
-    if (h->root) free_pair_node(h->root);
+    // Free all nodes still in the heap (e.g. after an aborted search)
+    if (h->root) free_pair_node(h, h->root);
     
     // Free the map and the heap structure
-    free(h->map);
+    mem_free(&h->mem, h->map, (size_t)h->n * sizeof(PairNode *));
     free(h);
 }
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "partition.h"
+#include "memtrack.h"
+
+/*
+ * ======================================================================
+ * Unit Graphs
+ * ======================================================================
+ * Region growing always runs on a "unit graph". On level 0 the units
+ * are the graph nodes themselves and neighbours come straight from the
+ * adjacency lists. On higher levels the units are the cells of the
+ * level below, connected through a CSR quotient graph.
+ */
+
+typedef struct {
+    int num_units;
+    const Graph *g;       // Non-NULL on level 0 (neighbours from adj/rev_adj)
+    const int *xadj;      // CSR offsets of the quotient graph (levels > 0)
+    const int *adjncy;    // CSR neighbours of the quotient graph (levels > 0)
+    const long *weight;   // Node count of each unit (NULL means 1 per unit)
+} UnitGraph;
+
+static int cmp_u64(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Builds an undirected CSR graph over 'k' units from a list of
+ * (a << 32 | b) keys. Keys are sorted and de-duplicated in place.
+ */
+static void build_csr(int k, unsigned long long *keys, long nkeys, int **xadj_out, int **adjncy_out) {
+    qsort(keys, nkeys, sizeof(unsigned long long), cmp_u64);
+
+    long uniq = 0;
+    for (long i = 0; i < nkeys; i++) {
+        if (uniq == 0 || keys[i] != keys[uniq - 1]) keys[uniq++] = keys[i];
+    }
+
+    int *xadj = xmalloc((k + 1) * sizeof(int));
+    int *adjncy = xmalloc((uniq > 0 ? uniq : 1) * sizeof(int));
+    memset(xadj, 0, (k + 1) * sizeof(int));
+
+    for (long i = 0; i < uniq; i++) xadj[(int)(keys[i] >> 32) + 1]++;
+    for (int c = 0; c < k; c++) xadj[c + 1] += xadj[c];
+    for (long i = 0; i < uniq; i++) adjncy[i] = (int)(keys[i] & 0xffffffffULL);
+
+    *xadj_out = xadj;
+    *adjncy_out = adjncy;
+}
+
+/**
+ * Builds the quotient graph of a node labelling: units a and b are
+ * adjacent if some arc connects a node labelled a with one labelled b.
+ */
+static void quotient_from_graph(const Graph *g, const int *label, int k, int **xadj, int **adjncy) {
+    long nkeys = 0;
+    for (int u = 0; u < g->num_nodes; u++)
+        for (Edge *e = g->adj[u]; e; e = e->next)
+            if (label[u] != label[e->to]) nkeys += 2;
+
+    unsigned long long *keys = xmalloc((nkeys > 0 ? nkeys : 1) * sizeof(unsigned long long));
+    long pos = 0;
+    for (int u = 0; u < g->num_nodes; u++) {
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            unsigned long long a = (unsigned)label[u], b = (unsigned)label[e->to];
+            if (a == b) continue;
+            keys[pos++] = (a << 32) | b;
+            keys[pos++] = (b << 32) | a;
+        }
+    }
+    build_csr(k, keys, nkeys, xadj, adjncy);
+    free(keys);
+}
+
+/**
+ * Builds the quotient of an existing CSR unit graph under 'label'
+ * (label[unit] = new cell of that unit).
+ */
+static void quotient_from_csr(const int *xadj_in, const int *adjncy_in, int units,
+                              const int *label, int k, int **xadj, int **adjncy) {
+    long nkeys = xadj_in[units];
+    unsigned long long *keys = xmalloc((nkeys > 0 ? nkeys : 1) * sizeof(unsigned long long));
+    long pos = 0;
+    for (int a = 0; a < units; a++) {
+        for (int i = xadj_in[a]; i < xadj_in[a + 1]; i++) {
+            unsigned long long la = (unsigned)label[a], lb = (unsigned)label[adjncy_in[i]];
+            if (la != lb) keys[pos++] = (la << 32) | lb;
+        }
+    }
+    build_csr(k, keys, pos, xadj, adjncy);
+    free(keys);
+}
+
+/*
+ * ======================================================================
+ * Region Growing
+ * ======================================================================
+ */
+
+static long unit_weight(const UnitGraph *ug, int u) {
+    return ug->weight ? ug->weight[u] : 1;
+}
+
+// Claims unit 'v' for region 'id' if it is free and still fits.
+static void try_claim(const UnitGraph *ug, int v, int id, long cap,
+                      int *region, long *size, int *queue, int *tail) {
+    if (region[v] != -1) return;
+    long w = unit_weight(ug, v);
+    if (*size + w > cap) return;
+    region[v] = id;
+    *size += w;
+    queue[(*tail)++] = v;
+}
+
+/**
+ * Grows regions of total weight <= 'cap' by BFS from the lowest
+ * unassigned unit. Writes region ids to 'region' and returns their count.
+ */
+static int grow_regions(const UnitGraph *ug, long cap, int *region) {
+    int n = ug->num_units;
+    int *queue = xmalloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) region[i] = -1;
+
+    int count = 0;
+    for (int seed = 0; seed < n; seed++) {
+        if (region[seed] != -1) continue;
+
+        int id = count++;
+        long size = unit_weight(ug, seed);
+        int head = 0, tail = 0;
+        region[seed] = id;
+        queue[tail++] = seed;
+
+        while (head < tail && size < cap) {
+            int u = queue[head++];
+            if (ug->g) {
+                // Level 0: treat the graph as undirected
+                for (Edge *e = ug->g->adj[u]; e; e = e->next)
+                    try_claim(ug, e->to, id, cap, region, &size, queue, &tail);
+                for (Edge *e = ug->g->rev_adj[u]; e; e = e->next)
+                    try_claim(ug, e->to, id, cap, region, &size, queue, &tail);
+            } else {
+                for (int i = ug->xadj[u]; i < ug->xadj[u + 1]; i++)
+                    try_claim(ug, ug->adjncy[i], id, cap, region, &size, queue, &tail);
+            }
+        }
+    }
+
+    free(queue);
+    return count;
+}
+
+static int find_root(int *parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]]; // Path halving
+        x = parent[x];
+    }
+    return x;
+}
+
+/**
+ * Merges fragments (cells smaller than cap/4) into their smallest
+ * neighbouring cell when the union still respects 'cap'.
+ * 'label' maps cell -> new compact cell id on return.
+ * Returns the number of cells after merging.
+ */
+static int merge_fragments(int k, const int *xadj, const int *adjncy, const long *weight,
+                           long cap, int *label) {
+    int *parent = xmalloc(k * sizeof(int));
+    long *size = xmalloc(k * sizeof(long));
+    for (int c = 0; c < k; c++) {
+        parent[c] = c;
+        size[c] = weight[c];
+    }
+
+    for (int c = 0; c < k; c++) {
+        int r = find_root(parent, c);
+        if (size[r] >= cap / 4) continue;
+
+        int best = -1;
+        for (int i = xadj[c]; i < xadj[c + 1]; i++) {
+            int rn = find_root(parent, adjncy[i]);
+            if (rn == r || size[r] + size[rn] > cap) continue;
+            if (best == -1 || size[rn] < size[best]) best = rn;
+        }
+        if (best != -1) {
+            parent[r] = best;
+            size[best] += size[r];
+        }
+    }
+
+    // Compact root ids to 0..count-1
+    int count = 0;
+    for (int c = 0; c < k; c++) label[c] = -1;
+    for (int c = 0; c < k; c++) {
+        int r = find_root(parent, c);
+        if (label[r] == -1) label[r] = count++;
+    }
+    for (int c = 0; c < k; c++) label[c] = label[find_root(parent, c)];
+
+    free(parent);
+    free(size);
+    return count;
+}
+
+/*
+ * ======================================================================
+ * Public API
+ * ======================================================================
+ */
+
+Partition* partition_graph(const Graph *g, int num_levels, const int *cell_sizes) {
+    int n = g->num_nodes;
+    Partition *p = xmalloc(sizeof(Partition));
+    p->num_levels = num_levels;
+    p->num_cells = xmalloc(num_levels * sizeof(int));
+    p->cell = xmalloc(num_levels * sizeof(int*));
+
+    for (int l = 0; l < num_levels; l++) {
+        long cap = cell_sizes[l];
+        int *cell = xmalloc(n * sizeof(int));
+        int *xadj = NULL, *adjncy = NULL;
+        int k;
+
+        if (l == 0) {
+            // Grow directly on the graph nodes
+            UnitGraph ug = { n, g, NULL, NULL, NULL };
+            k = grow_regions(&ug, cap, cell);
+            quotient_from_graph(g, cell, k, &xadj, &adjncy);
+        } else {
+            // Grow on the cells of the level below
+            int units = p->num_cells[l - 1];
+            const int *below = p->cell[l - 1];
+            long *uw = xmalloc(units * sizeof(long));
+            int *uxadj, *uadjncy;
+            memset(uw, 0, units * sizeof(long));
+            for (int v = 0; v < n; v++) uw[below[v]]++;
+            quotient_from_graph(g, below, units, &uxadj, &uadjncy);
+
+            int *region = xmalloc(units * sizeof(int));
+            UnitGraph ug = { units, NULL, uxadj, uadjncy, uw };
+            k = grow_regions(&ug, cap, region);
+            quotient_from_csr(uxadj, uadjncy, units, region, k, &xadj, &adjncy);
+            for (int v = 0; v < n; v++) cell[v] = region[below[v]];
+
+            free(region);
+            free(uxadj);
+            free(uadjncy);
+            free(uw);
+        }
+
+        // Merge leftover fragments produced by BFS growing
+        long *weight = xmalloc(k * sizeof(long));
+        int *label = xmalloc(k * sizeof(int));
+        memset(weight, 0, k * sizeof(long));
+        for (int v = 0; v < n; v++) weight[cell[v]]++;
+        k = merge_fragments(k, xadj, adjncy, weight, cap, label);
+        for (int v = 0; v < n; v++) cell[v] = label[cell[v]];
+
+        p->num_cells[l] = k;
+        p->cell[l] = cell;
+
+        free(label);
+        free(weight);
+        free(xadj);
+        free(adjncy);
+    }
+
+    return p;
+}
+
+void free_partition(Partition *p) {
+    if (!p) return;
+    for (int l = 0; l < p->num_levels; l++) free(p->cell[l]);
+    free(p->cell);
+    free(p->num_cells);
+    free(p);
+}
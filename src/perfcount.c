@@ -0,0 +1,154 @@
+#ifdef __linux__
+#define _GNU_SOURCE       // syscall()
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "perfcount.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static const char *event_names[PERF_NUM_EVENTS] = {
+    "cycles", "instructions", "L1D-misses", "LLC-misses", "dTLB-misses", "branch-misses"
+};
+
+const char* perf_event_name(int event) {
+    return (event >= 0 && event < PERF_NUM_EVENTS) ? event_names[event] : "?";
+}
+
+#ifdef __linux__
+
+// perf_event_open has no glibc wrapper.
+static int perf_event_open(struct perf_event_attr *attr, int group_fd) {
+    return (int)syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+// Cache events are encoded as cache | (op << 8) | (result << 16).
+static uint64_t cache_event(int cache) {
+    return (uint64_t)cache | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+PerfGroup* perf_open(void) {
+    PerfGroup *p = malloc(sizeof(PerfGroup));
+    if (!p) return NULL;
+    p->leader = -1;
+    p->num_open = 0;
+
+    int first_errno = 0;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        switch (i) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case PERF_DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        }
+        attr.disabled = (p->leader == -1); // Members follow the leader
+        attr.exclude_kernel = 1;           // Allowed with perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        p->fd[i] = perf_event_open(&attr, p->leader);
+        if (p->fd[i] < 0) {
+            if (!first_errno) first_errno = errno;
+            continue;
+        }
+        if (p->leader == -1) p->leader = p->fd[i];
+        p->num_open++;
+    }
+
+    if (p->num_open == 0) {
+        fprintf(stderr, "Warning: hardware counters unavailable (%s); "
+                "check /proc/sys/kernel/perf_event_paranoid\n", strerror(first_errno));
+        free(p);
+        return NULL;
+    }
+    if (p->num_open < PERF_NUM_EVENTS) {
+        fprintf(stderr, "Warning: counting only");
+        for (int i = 0; i < PERF_NUM_EVENTS; i++)
+            if (p->fd[i] >= 0) fprintf(stderr, " %s", event_names[i]);
+        fprintf(stderr, "\n");
+    }
+    return p;
+}
+
+void perf_start(PerfGroup *p) {
+    ioctl(p->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(p->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_stop(PerfGroup *p, uint64_t *values) {
+    ioctl(p->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        values[i] = UINT64_MAX;
+        if (p->fd[i] < 0) continue;
+        uint64_t buf[3]; // value, time enabled, time running
+        if (read(p->fd[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+        if (buf[2] == 0 && buf[1] > 0) continue; // Never scheduled
+        // Scale up if the kernel multiplexed the group with other events
+        if (buf[2] > 0 && buf[2] < buf[1])
+            values[i] = (uint64_t)((double)buf[0] * buf[1] / buf[2]);
+        else
+            values[i] = buf[0];
+    }
+}
+
+void perf_close(PerfGroup *p) {
+    if (!p) return;
+    // Members first, the leader last
+    for (int i = PERF_NUM_EVENTS - 1; i >= 0; i--)
+        if (p->fd[i] >= 0 && p->fd[i] != p->leader) close(p->fd[i]);
+    close(p->leader);
+    free(p);
+}
+
+#else // No perf_event_open: the profiling layer is always off
+
+PerfGroup* perf_open(void) {
+    fprintf(stderr, "Warning: hardware counters are only supported on Linux\n");
+    return NULL;
+}
+
+void perf_start(PerfGroup *p) {
+    (void)p;
+}
+
+void perf_stop(PerfGroup *p, uint64_t *values) {
+    (void)p;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) values[i] = UINT64_MAX;
+}
+
+void perf_close(PerfGroup *p) {
+    (void)p;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include <stdlib.h>
+#include "planner.h"
+#include "memtrack.h"
+
+// Query pairs being sorted (qsort has no context argument in C11).
+static const int *sort_queries;
+
+// Orders query indices by source, then by original position (stable).
+static int cmp_by_source(const void *a, const void *b) {
+    int i = *(const int*)a, j = *(const int*)b;
+    int si = sort_queries[i * 2], sj = sort_queries[j * 2];
+    if (si != sj) return (si < sj) ? -1 : 1;
+    return (i > j) - (i < j);
+}
+
+QueryPlan* plan_by_source(const int *queries, int n) {
+    QueryPlan *p = xmalloc(sizeof(QueryPlan));
+    p->num_queries = n;
+    p->order = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    p->group_start = xmalloc((n + 1) * sizeof(int));
+
+    for (int i = 0; i < n; i++) p->order[i] = i;
+    sort_queries = queries;
+    qsort(p->order, n, sizeof(int), cmp_by_source);
+    sort_queries = NULL;
+
+    // A new group starts wherever the source changes
+    p->num_groups = 0;
+    for (int k = 0; k < n; k++) {
+        if (k == 0 || queries[p->order[k] * 2] != queries[p->order[k - 1] * 2])
+            p->group_start[p->num_groups++] = k;
+    }
+    p->group_start[p->num_groups] = n;
+    return p;
+}
+
+void free_query_plan(QueryPlan *p) {
+    if (!p) return;
+    free(p->order);
+    free(p->group_start);
+    free(p);
+}
@@ -0,0 +1,181 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L   // gethostname()
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "runlog.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// CSV column / JSON key of each QueryPhase.
+static const char *phase_keys[NUM_PHASES] = {
+    "alloc", "init", "heap_create", "search", "teardown"
+};
+
+static const char *status_names[] = { "ok", "unreachable", "timeout" };
+
+const char* runlog_host(void) {
+    static char host[256];
+#ifdef _WIN32
+    const char *name = getenv("COMPUTERNAME");
+    snprintf(host, sizeof(host), "%s", name ? name : "unknown");
+#else
+    if (gethostname(host, sizeof(host)) != 0) snprintf(host, sizeof(host), "unknown");
+    host[sizeof(host) - 1] = '\0';
+#endif
+    return host;
+}
+
+const char* runlog_build(void) {
+    static char build[256];
+    int len = 0;
+#if defined(__clang__)
+    len += snprintf(build + len, sizeof(build) - len, "clang %s", __clang_version__);
+#elif defined(__GNUC__)
+    len += snprintf(build + len, sizeof(build) - len, "gcc %s", __VERSION__);
+#else
+    len += snprintf(build + len, sizeof(build) - len, "unknown compiler");
+#endif
+#ifdef __OPTIMIZE__
+    len += snprintf(build + len, sizeof(build) - len, ", optimized");
+#else
+    len += snprintf(build + len, sizeof(build) - len, ", not optimized");
+#endif
+#ifdef _OPENMP
+    len += snprintf(build + len, sizeof(build) - len, ", openmp");
+#endif
+#ifdef HEAP_STATS
+    len += snprintf(build + len, sizeof(build) - len, ", heap_stats");
+#endif
+#ifdef DEBUG
+    len += snprintf(build + len, sizeof(build) - len, ", debug");
+#endif
+#ifdef __SANITIZE_ADDRESS__
+    len += snprintf(build + len, sizeof(build) - len, ", asan");
+#endif
+    (void)len;
+    return build;
+}
+
+// Writes 's' as a JSON string literal.
+static void json_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(f, "\\%c", c);
+        else if (c < 0x20) fprintf(f, "\\u%04x", c);
+        else fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+RunLog* runlog_open(const char *csv_path, const char *json_path, const RunInfo *info,
+                    const char **counter_names, int num_counters) {
+    FILE *csv = fopen(csv_path, "w");
+    FILE *json = csv ? fopen(json_path, "w") : NULL;
+    if (!csv || !json) {
+        fprintf(stderr, "Warning: cannot write run log %s\n", csv ? json_path : csv_path);
+        if (csv) fclose(csv);
+        return NULL;
+    }
+    RunLog *log = malloc(sizeof(RunLog));
+    if (!log) {
+        fclose(csv);
+        fclose(json);
+        return NULL;
+    }
+    log->csv = csv;
+    log->json = json;
+    log->num_counters = num_counters;
+    log->rows = 0;
+    log->reachable = 0;
+    log->timeouts = 0;
+    log->total_time = 0;
+
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    const char *host = runlog_host();
+    const char *build = runlog_build();
+
+    fprintf(csv, "# host=%s\n# build=%s\n# timestamp=%s\n", host, build, stamp);
+    fprintf(csv, "# graph=%s\n# nodes=%d\n# edges=%ld\n", info->graph_file, info->num_nodes, info->num_edges);
+    fprintf(csv, "# query_file=%s\n# heap=%s\n", info->query_file, info->heap_type);
+    fprintf(csv, "# timeout_sec=%g\n# max_settled=%ld\n", info->timeout, info->max_settled);
+    fprintf(csv, "s,t,status,dist");
+    for (int p = 0; p < NUM_PHASES; p++) fprintf(csv, ",%s_s", phase_keys[p]);
+    fprintf(csv, ",total_s");
+    for (int c = 0; c < num_counters; c++) fprintf(csv, ",%s", counter_names[c]);
+    fprintf(csv, "\n");
+
+    fprintf(json, "{\n  \"host\": ");
+    json_string(json, host);
+    fprintf(json, ",\n  \"build\": ");
+    json_string(json, build);
+    fprintf(json, ",\n  \"timestamp\": \"%s\",\n  \"graph\": ", stamp);
+    json_string(json, info->graph_file);
+    fprintf(json, ",\n  \"nodes\": %d,\n  \"edges\": %ld,\n  \"query_file\": ", info->num_nodes, info->num_edges);
+    json_string(json, info->query_file);
+    fprintf(json, ",\n  \"heap\": ");
+    json_string(json, info->heap_type);
+    fprintf(json, ",\n  \"timeout_sec\": %g,\n  \"max_settled\": %ld,\n  \"counters\": [",
+            info->timeout, info->max_settled);
+    for (int c = 0; c < num_counters; c++) {
+        if (c > 0) fprintf(json, ", ");
+        json_string(json, counter_names[c]);
+    }
+    fprintf(json, "],\n  \"queries\": [");
+    return log;
+}
+
+void runlog_add(RunLog *log, int s, int t, RunStatus status, double dist,
+                const double *phase, const long long *counters) {
+    double total = 0;
+    for (int p = 0; p < NUM_PHASES; p++) total += phase[p];
+    log->total_time += total;
+    if (status == RUN_OK) log->reachable++;
+    if (status == RUN_TIMEOUT) log->timeouts++;
+
+    fprintf(log->csv, "%d,%d,%s,", s, t, status_names[status]);
+    if (status == RUN_OK) fprintf(log->csv, "%.6f", dist);
+    for (int p = 0; p < NUM_PHASES; p++) fprintf(log->csv, ",%.9f", phase[p]);
+    fprintf(log->csv, ",%.9f", total);
+    for (int c = 0; c < log->num_counters; c++) {
+        if (counters[c] < 0) fprintf(log->csv, ",");
+        else fprintf(log->csv, ",%lld", counters[c]);
+    }
+    fprintf(log->csv, "\n");
+
+    fprintf(log->json, "%s\n    {\"s\": %d, \"t\": %d, \"status\": \"%s\", \"dist\": ",
+            log->rows > 0 ? "," : "", s, t, status_names[status]);
+    if (status == RUN_OK) fprintf(log->json, "%.6f", dist);
+    else fprintf(log->json, "null");
+    for (int p = 0; p < NUM_PHASES; p++) fprintf(log->json, ", \"%s\": %.9f", phase_keys[p], phase[p]);
+    fprintf(log->json, ", \"total\": %.9f", total);
+    if (log->num_counters > 0) {
+        fprintf(log->json, ", \"counters\": [");
+        for (int c = 0; c < log->num_counters; c++) {
+            if (c > 0) fprintf(log->json, ", ");
+            if (counters[c] < 0) fprintf(log->json, "null");
+            else fprintf(log->json, "%lld", counters[c]);
+        }
+        fprintf(log->json, "]");
+    }
+    fprintf(log->json, "}");
+    log->rows++;
+}
+
+void runlog_close(RunLog *log, double wall_time) {
+    if (!log) return;
+    fprintf(log->json, "%s],\n", log->rows > 0 ? "\n  " : "");
+    fprintf(log->json, "  \"summary\": {\"queries\": %d, \"reachable\": %d, \"timeouts\": %d, "
+            "\"total_time\": %.9f, \"wall_time\": %.9f}\n}\n",
+            log->rows, log->reachable, log->timeouts, log->total_time, wall_time);
+    fclose(log->csv);
+    fclose(log->json);
+    free(log);
+}
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "scc.h"
+#include "memtrack.h"
+
+// File header of a persisted index (SCC1 files had no arc checksum).
+#define SCC_MAGIC "SCC2"
+
+// One frame of the explicit Tarjan call stack.
+typedef struct {
+    int node;
+    Edge *next;           // Next arc of 'node' to examine
+} TarjanFrame;
+
+/**
+ * Iterative Tarjan. Fills x->comp and x->num_comps; components are
+ * numbered in the order they are completed (sinks of the DAG first).
+ */
+static void tarjan(const Graph *g, SccIndex *x) {
+    int n = g->num_nodes;
+    int *index = xmalloc(n * sizeof(int));
+    int *low = xmalloc(n * sizeof(int));
+    int *stack = xmalloc(n * sizeof(int));
+    TarjanFrame *calls = xmalloc(n * sizeof(TarjanFrame));
+    for (int v = 0; v < n; v++) {
+        index[v] = -1;
+        x->comp[v] = -1;       // -1 while unfinished: marks "on the Tarjan stack"
+    }
+
+    int counter = 0, sp = 0, comps = 0;
+    for (int root = 0; root < n; root++) {
+        if (index[root] >= 0) continue;
+
+        int depth = 0;
+        calls[depth].node = root;
+        calls[depth].next = g->adj[root];
+        index[root] = low[root] = counter++;
+        stack[sp++] = root;
+
+        while (depth >= 0) {
+            TarjanFrame *f = &calls[depth];
+            int u = f->node;
+
+            if (f->next) {
+                Edge *e = f->next;
+                f->next = e->next;
+                int v = e->to;
+                if (index[v] < 0) {
+                    // Descend into v
+                    index[v] = low[v] = counter++;
+                    stack[sp++] = v;
+                    depth++;
+                    calls[depth].node = v;
+                    calls[depth].next = g->adj[v];
+                } else if (x->comp[v] < 0 && index[v] < low[u]) {
+                    low[u] = index[v]; // v is on the stack
+                }
+                continue;
+            }
+
+            // All arcs of u done: pop a component if u is its root
+            if (low[u] == index[u]) {
+                int v;
+                do {
+                    v = stack[--sp];
+                    x->comp[v] = comps;
+                } while (v != u);
+                comps++;
+            }
+            depth--;
+            if (depth >= 0) {
+                int p = calls[depth].node;
+                if (low[u] < low[p]) low[p] = low[u];
+            }
+        }
+    }
+    x->num_comps = comps;
+
+    free(index);
+    free(low);
+    free(stack);
+    free(calls);
+}
+
+// Marks (with 'flag') the components of every node reached from 'src' over 'lists'.
+static void mark_reached(const Graph *g, Edge **lists, int src, SccIndex *x, unsigned char flag) {
+    int n = g->num_nodes;
+    char *seen = xcalloc(n, 1);
+    int *queue = xmalloc(n * sizeof(int));
+    int head = 0, tail = 0;
+    queue[tail++] = src;
+    seen[src] = 1;
+    while (head < tail) {
+        int u = queue[head++];
+        x->flags[x->comp[u]] |= flag;
+        for (Edge *e = lists[u]; e; e = e->next) {
+            if (!seen[e->to]) {
+                seen[e->to] = 1;
+                queue[tail++] = e->to;
+            }
+        }
+    }
+    free(seen);
+    free(queue);
+}
+
+// splitmix64 finalizer.
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Checksum of the arcs of 'g': the sum of a hash of every (tail, head,
+ * weight). It does not depend on the order of the adjacency lists, and
+ * any changed endpoint or weight changes it with high probability.
+ */
+static uint64_t arc_checksum(const Graph *g) {
+    uint64_t sum = 0;
+    for (int u = 0; u < g->num_nodes; u++) {
+        for (Edge *e = g->adj[u]; e; e = e->next) {
+            uint64_t key = (uint64_t)(uint32_t)u << 32 | (uint32_t)e->to, w;
+            memcpy(&w, &e->weight, sizeof(w));
+            sum += mix64(mix64(key + 0x9E3779B97F4A7C15ULL) ^ w);
+        }
+    }
+    return sum;
+}
+
+SccIndex* scc_build(const Graph *g) {
+    int n = g->num_nodes;
+    SccIndex *x = xmalloc(sizeof(SccIndex));
+    x->num_nodes = n;
+    x->num_edges = g->num_edges;
+    x->arc_hash = arc_checksum(g);
+    x->comp = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    tarjan(g, x);
+
+    int c = x->num_comps;
+    int *size = xcalloc(c > 0 ? c : 1, sizeof(int));
+    x->level = xcalloc(c > 0 ? c : 1, sizeof(int));
+    x->flags = xcalloc(c > 0 ? c : 1, 1);
+
+    // Nodes grouped by component (CSR), and the giant component
+    int *start = xcalloc(c + 1, sizeof(int));
+    int *nodes = xmalloc((n > 0 ? n : 1) * sizeof(int));
+    for (int v = 0; v < n; v++) size[x->comp[v]]++;
+    x->giant = 0;
+    for (int k = 0; k < c; k++) {
+        start[k + 1] = start[k] + size[k];
+        if (size[k] > size[x->giant]) x->giant = k;
+    }
+    x->giant_size = c > 0 ? size[x->giant] : 0;
+    for (int v = 0; v < n; v++) nodes[start[x->comp[v]] + --size[x->comp[v]]] = v;
+
+    // Levels: successors of a component have lower ids, so ascending order works
+    for (int k = 0; k < c; k++) {
+        for (int i = start[k]; i < start[k + 1]; i++) {
+            for (Edge *e = g->adj[nodes[i]]; e; e = e->next) {
+                int d = x->comp[e->to];
+                if (d != k && x->level[d] + 1 > x->level[k]) x->level[k] = x->level[d] + 1;
+            }
+        }
+    }
+
+    if (c > 0) {
+        int rep = nodes[start[x->giant]];
+        mark_reached(g, g->adj, rep, x, SCC_FROM_GIANT);
+        mark_reached(g, g->rev_adj, rep, x, SCC_TO_GIANT);
+    }
+
+    free(size);
+    free(start);
+    free(nodes);
+    return x;
+}
+
+int scc_query(const SccIndex *x, int s, int t) {
+    if (s < 0 || t < 0 || s >= x->num_nodes || t >= x->num_nodes) return SCC_UNREACHABLE;
+    int cs = x->comp[s], ct = x->comp[t];
+    if (cs == ct) return SCC_REACHABLE;
+
+    // Condensation arcs only go to lower ids and lower levels
+    if (cs < ct || x->level[cs] <= x->level[ct]) return SCC_UNREACHABLE;
+
+    if (cs == x->giant) return (x->flags[ct] & SCC_FROM_GIANT) ? SCC_REACHABLE : SCC_UNREACHABLE;
+    if (ct == x->giant) return (x->flags[cs] & SCC_TO_GIANT) ? SCC_REACHABLE : SCC_UNREACHABLE;
+    if ((x->flags[cs] & SCC_TO_GIANT) && (x->flags[ct] & SCC_FROM_GIANT)) return SCC_REACHABLE;
+    return SCC_UNKNOWN;
+}
+
+/*
+ * ======================================================================
+ * Persistence
+ * ======================================================================
+ * Layout: "SCC1", int32 nodes, int64 arcs, int32 components,
+ * int32 giant, int32 comp[nodes], int32 level[components],
+ * uint8 flags[components].
+ */
+
+int scc_save(const SccIndex *x, const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    int32_t nodes = x->num_nodes;
+    int64_t m = x->num_edges;
+    uint64_t hash = x->arc_hash;
+    int32_t tail[2] = { x->num_comps, x->giant };
+    int ok = fwrite(SCC_MAGIC, 1, 4, f) == 4 &&
+             fwrite(&nodes, sizeof(int32_t), 1, f) == 1 &&
+             fwrite(&m, sizeof(int64_t), 1, f) == 1 &&
+             fwrite(&hash, sizeof(uint64_t), 1, f) == 1 &&
+             fwrite(tail, sizeof(int32_t), 2, f) == 2 &&
+             fwrite(x->comp, sizeof(int32_t), x->num_nodes, f) == (size_t)x->num_nodes &&
+             fwrite(x->level, sizeof(int32_t), x->num_comps, f) == (size_t)x->num_comps &&
+             fwrite(x->flags, 1, x->num_comps, f) == (size_t)x->num_comps;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+// Reads an index saved by scc_save. Returns NULL if missing, corrupt or built for another graph.
+static SccIndex* scc_load(const Graph *g, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    char magic[4];
+    int32_t nodes, tail[2];
+    int64_t m;
+    uint64_t hash;
+    if (fread(magic, 1, 4, f) != 4 || memcmp(magic, SCC_MAGIC, 4) != 0 ||
+        fread(&nodes, sizeof(int32_t), 1, f) != 1 || fread(&m, sizeof(int64_t), 1, f) != 1 ||
+        fread(&hash, sizeof(uint64_t), 1, f) != 1 || fread(tail, sizeof(int32_t), 2, f) != 2 ||
+        tail[0] < 0 || tail[0] > nodes || tail[1] < 0 || (nodes > 0 && tail[1] >= tail[0])) {
+        fclose(f);
+        return NULL;
+    }
+    if (nodes != g->num_nodes || m != g->num_edges || hash != arc_checksum(g)) {
+        printf("SCC index %s was built for a different graph, rebuilding\n", path);
+        fclose(f);
+        return NULL;
+    }
+
+    SccIndex *x = xmalloc(sizeof(SccIndex));
+    x->num_nodes = nodes;
+    x->num_edges = m;
+    x->arc_hash = hash;
+    x->num_comps = tail[0];
+    x->giant = tail[1];
+    x->comp = xmalloc((nodes > 0 ? nodes : 1) * sizeof(int));
+    x->level = xmalloc((tail[0] > 0 ? tail[0] : 1) * sizeof(int));
+    x->flags = xmalloc(tail[0] > 0 ? tail[0] : 1);
+    int ok = fread(x->comp, sizeof(int32_t), nodes, f) == (size_t)nodes &&
+             fread(x->level, sizeof(int32_t), tail[0], f) == (size_t)tail[0] &&
+             fread(x->flags, 1, tail[0], f) == (size_t)tail[0];
+    fclose(f);
+
+    for (int v = 0; ok && v < nodes; v++)
+        if (x->comp[v] < 0 || x->comp[v] >= x->num_comps) ok = 0;
+    if (!ok) {
+        free_scc_index(x);
+        return NULL;
+    }
+
+    x->giant_size = 0;
+    for (int v = 0; v < nodes; v++)
+        if (x->comp[v] == x->giant) x->giant_size++;
+    return x;
+}
+
+SccIndex* scc_load_or_build(const Graph *g, const char *path) {
+    SccIndex *x = scc_load(g, path);
+    if (x) return x;
+
+    x = scc_build(g);
+    if (scc_save(x, path) != 0)
+        fprintf(stderr, "Warning: could not save SCC index to %s\n", path);
+    return x;
+}
+
+void free_scc_index(SccIndex *x) {
+    if (!x) return;
+    free(x->comp);
+    free(x->level);
+    free(x->flags);
+    free(x);
+}
@@ -0,0 +1,380 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "synthgraph.h"
+#include "memtrack.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Arcs (or RGG points) drawn from one random stream; fixed so the graph
+// does not depend on the thread count.
+#define SYNTH_BLOCK 65536
+
+// Side of the RGG square; weights are 1 + floor(Euclidean distance).
+#define RGG_SIDE 1e6
+
+// R-MAT quadrant probabilities (Graph500); d = 1 - a - b - c.
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+// Bytes malloc takes for one Edge (24 bytes plus chunk header).
+#define EDGE_ALLOC_BYTES 32
+
+static const double PI = 3.14159265358979323846;
+
+static const char *kind_names[SYNTH_NUM_KINDS] = { "grid", "rgg", "gnm", "rmat" };
+
+// An arc (u -> v) produced by a generator before it goes into the lists.
+typedef struct {
+    int u, v;
+    double w;
+} SynthArc;
+
+// splitmix64 stream.
+typedef struct {
+    unsigned long long s;
+} Rng;
+
+static unsigned long long rng_next(Rng *r) {
+    unsigned long long z = (r->s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, n) for n < 2^32.
+static unsigned rng_below(Rng *r, unsigned n) {
+    return (unsigned)(((rng_next(r) >> 32) * (unsigned long long)n) >> 32);
+}
+
+// Uniform in [0, 1).
+static double rng_uniform(Rng *r) {
+    return (rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+// The independent stream of block 'block' under 'seed'.
+static Rng block_rng(unsigned long long seed, unsigned long long block) {
+    Rng h = { block };
+    Rng r = { seed ^ rng_next(&h) };
+    rng_next(&r);
+    return r;
+}
+
+#ifdef _OPENMP
+// Thread count for the generator loops (only referenced from pragmas).
+static int synth_threads(int threads) {
+    return threads > 0 ? threads : omp_get_max_threads();
+}
+#endif
+
+/**
+ * Creates a graph from 'm' arcs in array order. With 'both' each arc is
+ * also added in the opposite direction (undirected generators).
+ * List insertion stays serial: edges are allocated one by one and
+ * counted in g->mem, neither of which is thread-safe.
+ */
+static Graph* build_graph(int n, const SynthArc *arcs, long m, int both) {
+    Graph *g = create_graph(n);
+    for (long i = 0; i < m; i++) {
+        add_arc(g, arcs[i].u, arcs[i].v, arcs[i].w);
+        if (both) add_arc(g, arcs[i].v, arcs[i].u, arcs[i].w);
+    }
+    return g;
+}
+
+const char* synth_kind_name(SynthKind kind) {
+    return (kind >= 0 && kind < SYNTH_NUM_KINDS) ? kind_names[kind] : "unknown";
+}
+
+void synth_defaults(SynthKind kind, int n, SynthParams *p) {
+    static const double degree[SYNTH_NUM_KINDS] = { 4, 6, 4, 16 };
+    p->kind = kind;
+    p->n = n;
+    p->degree = degree[kind];
+    p->max_weight = 1000;
+    p->seed = 1;
+    p->threads = 0;
+}
+
+int synth_parse(const char *spec, SynthParams *p) {
+    const char *colon = strchr(spec, ':');
+    if (!colon) return 0;
+    int kind = -1;
+    for (int k = 0; k < SYNTH_NUM_KINDS; k++)
+        if ((size_t)(colon - spec) == strlen(kind_names[k]) && strncmp(spec, kind_names[k], colon - spec) == 0)
+            kind = k;
+    if (kind < 0) return 0;
+
+    char *end;
+    double n = strtod(colon + 1, &end);
+    if (end == colon + 1 || n < 2 || n > INT_MAX) {
+        fprintf(stderr, "Bad node count in graph spec %s\n", spec);
+        return 0;
+    }
+    synth_defaults((SynthKind)kind, (int)n, p);
+    if (*end == ':') {
+        const char *d = end + 1;
+        double degree = strtod(d, &end);
+        if (end == d || degree <= 0) {
+            fprintf(stderr, "Bad degree in graph spec %s\n", spec);
+            return 0;
+        }
+        p->degree = degree;
+    }
+    if (*end == ':') p->seed = strtoull(end + 1, &end, 10);
+    if (*end != '\0') {
+        fprintf(stderr, "Bad graph spec %s (expected kind:n[:degree[:seed]])\n", spec);
+        return 0;
+    }
+    return 1;
+}
+
+size_t synth_estimate_bytes(const SynthParams *p) {
+    double n = p->n;
+    double arcs = (p->kind == SYNTH_GRID) ? 4 * n : p->degree * n;
+    double temp;
+    switch (p->kind) {
+    case SYNTH_GRID: temp = arcs / 2 * sizeof(SynthArc); break;
+    case SYNTH_RGG: temp = arcs / 2 * sizeof(SynthArc) + n * 48; break; // Points, cells, offsets
+    case SYNTH_RMAT: temp = arcs * sizeof(SynthArc) + n * sizeof(int); break; // + permutation
+    default: temp = arcs * sizeof(SynthArc); break;
+    }
+    return (size_t)(n * 2 * sizeof(Edge*) + arcs * 2 * EDGE_ALLOC_BYTES + temp);
+}
+
+Graph* synth_generate(const SynthParams *p) {
+    switch (p->kind) {
+    case SYNTH_GRID: {
+        int side = (int)(sqrt((double)p->n) + 0.5);
+        if (side < 2) side = 2;
+        return synth_grid(side, side, p->max_weight, p->seed, p->threads);
+    }
+    case SYNTH_RGG:
+        return synth_rgg(p->n, p->degree, p->seed, p->threads);
+    case SYNTH_GNM:
+        return synth_gnm(p->n, (long)(p->n * p->degree + 0.5), p->max_weight, p->seed, p->threads);
+    case SYNTH_RMAT:
+        return synth_rmat(p->n, (long)(p->n * p->degree + 0.5), p->max_weight, p->seed, p->threads);
+    default:
+        return NULL;
+    }
+}
+
+Graph* synth_grid(int rows, int cols, int max_weight, unsigned long long seed, int threads) {
+    if ((long long)rows * cols > INT_MAX) {
+        fprintf(stderr, "Error: %d x %d grid has too many nodes.\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+    // Row r holds its cols-1 horizontal edges and, except the last row,
+    // its cols edges down to row r+1
+    long per_row = 2L * cols - 1;
+    long m = (long)(rows - 1) * per_row + cols - 1;
+    SynthArc *arcs = xmalloc(m * sizeof(SynthArc));
+
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(static)
+    for (int r = 0; r < rows; r++) {
+        Rng rng = block_rng(seed, r);
+        SynthArc *a = arcs + r * per_row;
+        int base = r * cols;
+        for (int c = 0; c < cols; c++) {
+            if (c + 1 < cols)
+                *a++ = (SynthArc){ base + c, base + c + 1, 1 + rng_below(&rng, max_weight) };
+            if (r + 1 < rows)
+                *a++ = (SynthArc){ base + c, base + cols + c, 1 + rng_below(&rng, max_weight) };
+        }
+    }
+
+    Graph *g = build_graph(rows * cols, arcs, m, 1);
+    free(arcs);
+    return g;
+}
+
+// Points of an RGG bucketed into square cells of at least the radius.
+typedef struct {
+    const double *x, *y;  // Point coordinates, sorted by cell
+    const long *start;    // Points of cell c are start[c] .. start[c+1]-1
+    int cells;            // Cells per side
+    double cell_size;
+    double radius;
+} RggIndex;
+
+static int rgg_cell(const RggIndex *ix, double x) {
+    int c = (int)(x / ix->cell_size);
+    return c < ix->cells ? c : ix->cells - 1;
+}
+
+/**
+ * Finds the neighbours j > i of point i within the radius and, if 'out'
+ * is not NULL, writes the edges (i, j) there. Returns their number.
+ */
+static long rgg_neighbours(const RggIndex *ix, int i, SynthArc *out) {
+    int cx = rgg_cell(ix, ix->x[i]), cy = rgg_cell(ix, ix->y[i]);
+    double r2 = ix->radius * ix->radius;
+    long found = 0;
+    for (int y = cy - 1; y <= cy + 1; y++) {
+        if (y < 0 || y >= ix->cells) continue;
+        for (int x = cx - 1; x <= cx + 1; x++) {
+            if (x < 0 || x >= ix->cells) continue;
+            long c = (long)y * ix->cells + x;
+            for (long j = ix->start[c]; j < ix->start[c + 1]; j++) {
+                if (j <= i) continue;
+                double dx = ix->x[j] - ix->x[i], dy = ix->y[j] - ix->y[i];
+                double d2 = dx * dx + dy * dy;
+                if (d2 >= r2) continue;
+                if (out) out[found] = (SynthArc){ i, (int)j, 1 + floor(sqrt(d2)) };
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+Graph* synth_rgg(int n, double degree, unsigned long long seed, int threads) {
+    double radius = RGG_SIDE * sqrt(degree / (PI * n));
+    double per_side = RGG_SIDE / radius;
+    int cells = per_side < 1 ? 1 : per_side > 32768 ? 32768 : (int)per_side;
+    long num_cells = (long)cells * cells;
+
+    // Draw the points
+    double *px = xmalloc(n * sizeof(double));
+    double *py = xmalloc(n * sizeof(double));
+    long blocks = (n + SYNTH_BLOCK - 1) / SYNTH_BLOCK;
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(static)
+    for (long b = 0; b < blocks; b++) {
+        Rng rng = block_rng(seed, b);
+        long end = (b + 1) * SYNTH_BLOCK < n ? (b + 1) * SYNTH_BLOCK : n;
+        for (long i = b * SYNTH_BLOCK; i < end; i++) {
+            px[i] = rng_uniform(&rng) * RGG_SIDE;
+            py[i] = rng_uniform(&rng) * RGG_SIDE;
+        }
+    }
+
+    // Counting sort by cell; the sorted position becomes the node id
+    RggIndex ix = { NULL, NULL, NULL, cells, RGG_SIDE / cells, radius };
+    long *start = xcalloc(num_cells + 1, sizeof(long));
+    int *cell_of = xmalloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        long c = (long)rgg_cell(&ix, py[i]) * cells + rgg_cell(&ix, px[i]);
+        cell_of[i] = (int)c;
+        start[c + 1]++;
+    }
+    for (long c = 0; c < num_cells; c++) start[c + 1] += start[c];
+    double *sx = xmalloc(n * sizeof(double));
+    double *sy = xmalloc(n * sizeof(double));
+    long *fill = xmalloc(num_cells * sizeof(long));
+    memcpy(fill, start, num_cells * sizeof(long));
+    for (int i = 0; i < n; i++) {
+        long k = fill[cell_of[i]]++;
+        sx[k] = px[i];
+        sy[k] = py[i];
+    }
+    free(fill);
+    free(cell_of);
+    free(px);
+    free(py);
+    ix.x = sx;
+    ix.y = sy;
+    ix.start = start;
+
+    // Count the edges of each point, then write them at their offsets
+    long *offset = xmalloc((n + 1L) * sizeof(long));
+    offset[0] = 0;
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(dynamic, 1024)
+    for (int i = 0; i < n; i++) offset[i + 1] = rgg_neighbours(&ix, i, NULL);
+    for (int i = 0; i < n; i++) offset[i + 1] += offset[i];
+    long m = offset[n];
+    SynthArc *arcs = xmalloc(m * sizeof(SynthArc));
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(dynamic, 1024)
+    for (int i = 0; i < n; i++) rgg_neighbours(&ix, i, arcs + offset[i]);
+    free(offset);
+    free(start);
+    free(sx);
+    free(sy);
+
+    Graph *g = build_graph(n, arcs, m, 1);
+    free(arcs);
+    return g;
+}
+
+Graph* synth_gnm(int n, long m, int max_weight, unsigned long long seed, int threads) {
+    SynthArc *arcs = xmalloc(m * sizeof(SynthArc));
+    long blocks = (m + SYNTH_BLOCK - 1) / SYNTH_BLOCK;
+
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(static)
+    for (long b = 0; b < blocks; b++) {
+        Rng rng = block_rng(seed, b);
+        long end = (b + 1) * SYNTH_BLOCK < m ? (b + 1) * SYNTH_BLOCK : m;
+        for (long i = b * SYNTH_BLOCK; i < end; i++) {
+            int u = rng_below(&rng, n), v;
+            do v = rng_below(&rng, n); while (v == u);
+            arcs[i] = (SynthArc){ u, v, 1 + rng_below(&rng, max_weight) };
+        }
+    }
+
+    Graph *g = build_graph(n, arcs, m, 0);
+    free(arcs);
+    return g;
+}
+
+// Draws one R-MAT arc over 2^scale ids, redrawing until both ends are < n
+// and differ.
+static void rmat_arc(Rng *rng, int scale, int n, int *u, int *v) {
+    do {
+        *u = *v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double p = rng_uniform(rng);
+            if (p >= RMAT_A + RMAT_B) *u |= 1 << bit;               // Quadrants c, d
+            if (p >= RMAT_A && (p < RMAT_A + RMAT_B || p >= RMAT_A + RMAT_B + RMAT_C))
+                *v |= 1 << bit;                                      // Quadrants b, d
+        }
+    } while (*u >= n || *v >= n || *u == *v);
+}
+
+Graph* synth_rmat(int n, long m, int max_weight, unsigned long long seed, int threads) {
+    int scale = 1;
+    while ((1L << scale) < n) scale++;
+    SynthArc *arcs = xmalloc(m * sizeof(SynthArc));
+    long blocks = (m + SYNTH_BLOCK - 1) / SYNTH_BLOCK;
+
+    // Random relabelling; stream ~0 is never a block index in practice
+    int *perm = xmalloc(n * sizeof(int));
+    Rng prng = block_rng(seed, ~0ULL);
+    for (int i = 0; i < n; i++) perm[i] = i;
+    for (int i = n - 1; i > 0; i--) {
+        int j = rng_below(&prng, i + 1);
+        int tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+    }
+
+    #pragma omp parallel for num_threads(synth_threads(threads)) schedule(static)
+    for (long b = 0; b < blocks; b++) {
+        Rng rng = block_rng(seed, b);
+        long end = (b + 1) * SYNTH_BLOCK < m ? (b + 1) * SYNTH_BLOCK : m;
+        for (long i = b * SYNTH_BLOCK; i < end; i++) {
+            int u, v;
+            rmat_arc(&rng, scale, n, &u, &v);
+            arcs[i] = (SynthArc){ perm[u], perm[v], 1 + rng_below(&rng, max_weight) };
+        }
+    }
+    free(perm);
+
+    Graph *g = build_graph(n, arcs, m, 0);
+    free(arcs);
+    return g;
+}
+
+void synth_sources(const Graph *g, int count, unsigned long long seed, int *src) {
+    // Stream ~1, like ~0 for the R-MAT relabelling, is never a block index
+    Rng rng = block_rng(seed, ~1ULL);
+    for (int i = 0; i < count; i++) {
+        int s = rng_below(&rng, g->num_nodes);
+        for (int tries = 0; !g->adj[s] && tries < 100; tries++) s = rng_below(&rng, g->num_nodes);
+        src[i] = s;
+    }
+}
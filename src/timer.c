@@ -0,0 +1,37 @@
+#define _POSIX_C_SOURCE 200112L
+#include <time.h>
+#include "timer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+double timer_now(void) {
+#ifdef _WIN32
+    // QueryPerformanceCounter is the monotonic high-resolution clock on Windows
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+double timer_thread_cpu(void) {
+#ifdef _WIN32
+    FILETIME create, exit_time, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &create, &exit_time, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER u;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (double)u.QuadPart * 1e-7; // 100 ns units
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}